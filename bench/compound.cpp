@@ -0,0 +1,135 @@
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "nbt/nbt.hpp"
+
+/**
+ * Compound storage compared against the std::pmr::unordered_map it replaced.
+ */
+using MapCompound = std::pmr::unordered_map<nbt::String, nbt::Value>;
+
+std::vector<std::string> createKeys(size_t count) {
+  static const char* names[] = {"id", "Pos", "Motion", "Rotation", "Count", "Name", "Health", "Fire", "Air", "OnGround"};
+
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < count; i++) {
+    keys.emplace_back(i < std::size(names) ? std::string(names[i]) : "key" + std::to_string(i));
+  }
+  return keys;
+}
+
+template<typename Storage>
+Storage createStorage(const std::vector<std::string>& keys) {
+  Storage storage;
+  int32_t value = 0;
+  for (const auto& key : keys) {
+    if constexpr (std::is_same_v<Storage, nbt::Compound>) {
+      storage.insert(key, value++);
+    } else {
+      storage.emplace(key, value++);
+    }
+  }
+  return storage;
+}
+
+template<typename Storage>
+void BM_Lookup(benchmark::State& state) {
+  auto keys = createKeys(static_cast<size_t>(state.range(0)));
+  Storage storage = createStorage<Storage>(keys);
+
+  size_t index = 0;
+  for (auto _ : state) {
+    const std::string& key = keys[index++ % keys.size()];
+    if constexpr (std::is_same_v<Storage, nbt::Compound>) {
+      benchmark::DoNotOptimize(storage.get(key));
+    } else {
+      benchmark::DoNotOptimize(storage.find(nbt::String(key)));
+    }
+  }
+}
+
+template<typename Storage>
+void BM_Iterate(benchmark::State& state) {
+  Storage storage = createStorage<Storage>(createKeys(static_cast<size_t>(state.range(0))));
+
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (const auto& pair : storage) {
+      sum += pair.second.getInt();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ParseCompounds(benchmark::State& state) {
+  auto keys = createKeys(static_cast<size_t>(state.range(0)));
+
+  nbt::List list(nbt::Type::COMPOUND);
+  for (size_t i = 0; i < 256; i++) {
+    list.pushBack(createStorage<nbt::Compound>(keys));
+  }
+  nbt::Compound document;
+  document["list"] = std::move(list);
+  auto buffer = nbt::Writer::writeToBuffer(document);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(nbt::Reader::parse(buffer.data(), buffer.size()));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buffer.size()));
+}
+
+/**
+ * Builds the compounds of a parsed document into Storage, so that both storages are filled by the same decoder.
+ */
+template<typename Storage>
+class StorageBuilder : public nbt::Visitor {
+ public:
+  bool onCompoundBegin(std::string_view /*name*/) override {
+    m_Compounds.emplace_back();
+    return true;
+  }
+
+  void onInt(std::string_view name, int32_t value) override {
+    if constexpr (std::is_same_v<Storage, nbt::Compound>) {
+      m_Compounds.back().insert(name, value);
+    } else {
+      m_Compounds.back().emplace(nbt::String(name), value);
+    }
+  }
+
+  std::vector<Storage>& getCompounds() { return m_Compounds; }
+ private:
+  std::vector<Storage> m_Compounds;
+};
+
+template<typename Storage>
+void BM_ParseInto(benchmark::State& state) {
+  auto keys = createKeys(static_cast<size_t>(state.range(0)));
+
+  nbt::List list(nbt::Type::COMPOUND);
+  for (size_t i = 0; i < 256; i++) {
+    list.pushBack(createStorage<nbt::Compound>(keys));
+  }
+  nbt::Compound document;
+  document["list"] = std::move(list);
+  auto buffer = nbt::Writer::writeToBuffer(document);
+
+  for (auto _ : state) {
+    StorageBuilder<Storage> builder;
+    nbt::Reader::visit(buffer.data(), buffer.size(), builder);
+    benchmark::DoNotOptimize(builder.getCompounds().data());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buffer.size()));
+}
+
+BENCHMARK_TEMPLATE(BM_Lookup, nbt::Compound)->Arg(4)->Arg(16)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_Lookup, MapCompound)->Arg(4)->Arg(16)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_Iterate, nbt::Compound)->Arg(4)->Arg(16)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_Iterate, MapCompound)->Arg(4)->Arg(16)->Arg(64)->Arg(1024);
+BENCHMARK(BM_ParseCompounds)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(BM_ParseInto, nbt::Compound)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(BM_ParseInto, MapCompound)->Arg(4)->Arg(16)->Arg(64);
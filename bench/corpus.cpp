@@ -0,0 +1,321 @@
+#include "corpus.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+uint32_t pick(std::mt19937& rng, uint32_t bound) {
+  return static_cast<uint32_t>(rng() % bound);
+}
+
+int64_t randomLong(std::mt19937& rng) {
+  return static_cast<int64_t>((static_cast<uint64_t>(rng()) << 32) | rng());
+}
+
+template<size_t N>
+const char* pick(std::mt19937& rng, const char* const (&values)[N]) {
+  return values[pick(rng, N)];
+}
+
+nbt::Compound createChunk(std::mt19937& rng) {
+  static const char* const blocks[] = {"minecraft:stone", "minecraft:deepslate", "minecraft:dirt", "minecraft:grass_block",
+                                       "minecraft:gravel", "minecraft:water", "minecraft:air", "minecraft:oak_log",
+                                       "minecraft:iron_ore", "minecraft:coal_ore", "minecraft:tuff", "minecraft:andesite"};
+  static const char* const biomes[] = {"minecraft:plains", "minecraft:forest", "minecraft:river", "minecraft:dripstone_caves"};
+  static const char* const heightmaps[] = {"MOTION_BLOCKING", "MOTION_BLOCKING_NO_LEAVES", "OCEAN_FLOOR", "WORLD_SURFACE"};
+
+  nbt::Compound chunk;
+  chunk["DataVersion"] = 3700;
+  chunk["xPos"] = static_cast<int32_t>(pick(rng, 1024)) - 512;
+  chunk["zPos"] = static_cast<int32_t>(pick(rng, 1024)) - 512;
+  chunk["yPos"] = -4;
+  chunk["Status"] = "minecraft:full";
+  chunk["LastUpdate"] = static_cast<int64_t>(pick(rng, 1000000));
+  chunk["InhabitedTime"] = static_cast<int64_t>(pick(rng, 100000));
+
+  nbt::List sections(nbt::Type::COMPOUND);
+  for (int32_t y = -4; y < 20; y++) {
+    uint32_t paletteSize = 1 + pick(rng, 32);
+    nbt::List palette(nbt::Type::COMPOUND);
+    for (uint32_t i = 0; i < paletteSize; i++) {
+      nbt::Compound state;
+      state["Name"] = pick(rng, blocks);
+      if (pick(rng, 3) == 0) {
+        nbt::Compound properties;
+        properties["axis"] = "y";
+        properties["waterlogged"] = "false";
+        state["Properties"] = std::move(properties);
+      }
+      palette.pushBack(std::move(state));
+    }
+
+    // Indices are packed into longs without spanning two of them, with at least 4 bits each
+    uint32_t bits = 4;
+    while ((1U << bits) < paletteSize) bits++;
+    uint32_t perLong = 64 / bits;
+    std::vector<int64_t> data((4096 + perLong - 1) / perLong);
+    for (auto& value : data) value = randomLong(rng);
+
+    nbt::Compound blockStates;
+    blockStates["palette"] = std::move(palette);
+    blockStates["data"] = data;
+
+    nbt::List biomePalette(nbt::Type::STRING);
+    for (uint32_t i = 0, count = 1 + pick(rng, 4); i < count; i++) biomePalette.pushBack(pick(rng, biomes));
+    nbt::Compound biomeStates;
+    biomeStates["palette"] = std::move(biomePalette);
+    std::vector<int64_t> biomeData(64);
+    for (auto& value : biomeData) value = randomLong(rng);
+    biomeStates["data"] = biomeData;
+
+    std::vector<int8_t> blockLight(2048), skyLight(2048);
+    for (size_t i = 0; i < blockLight.size(); i++) {
+      blockLight[i] = static_cast<int8_t>(pick(rng, 256));
+      skyLight[i] = static_cast<int8_t>(pick(rng, 256));
+    }
+
+    nbt::Compound section;
+    section["Y"] = static_cast<int8_t>(y);
+    section["block_states"] = std::move(blockStates);
+    section["biomes"] = std::move(biomeStates);
+    section["BlockLight"] = blockLight;
+    section["SkyLight"] = skyLight;
+    sections.pushBack(std::move(section));
+  }
+  chunk["sections"] = std::move(sections);
+
+  nbt::Compound heights;
+  for (const char* name : heightmaps) {
+    std::vector<int64_t> data(37);
+    for (auto& value : data) value = randomLong(rng);
+    heights[name] = data;
+  }
+  chunk["Heightmaps"] = std::move(heights);
+
+  nbt::List blockEntities(nbt::Type::COMPOUND);
+  for (int32_t i = 0; i < 64; i++) {
+    nbt::Compound entity;
+    entity["id"] = "minecraft:chest";
+    entity["x"] = static_cast<int32_t>(pick(rng, 16));
+    entity["y"] = static_cast<int32_t>(pick(rng, 384)) - 64;
+    entity["z"] = static_cast<int32_t>(pick(rng, 16));
+    entity["keepPacked"] = static_cast<int8_t>(0);
+    entity["Items"] = nbt::List(nbt::Type::COMPOUND);
+    blockEntities.pushBack(std::move(entity));
+  }
+  chunk["block_entities"] = std::move(blockEntities);
+
+  nbt::List postProcessing(nbt::Type::LIST);
+  for (int32_t i = 0; i < 24; i++) {
+    nbt::List positions(nbt::Type::SHORT);
+    for (uint32_t j = 0, count = pick(rng, 8); j < count; j++) positions.pushBack(static_cast<int16_t>(pick(rng, 4096)));
+    postProcessing.pushBack(std::move(positions));
+  }
+  chunk["PostProcessing"] = std::move(postProcessing);
+  return chunk;
+}
+
+nbt::Compound createEntities(std::mt19937& rng) {
+  static const char* const mobs[] = {"minecraft:zombie", "minecraft:skeleton", "minecraft:cow", "minecraft:sheep",
+                                     "minecraft:villager", "minecraft:creeper", "minecraft:item_frame", "minecraft:bat"};
+  static const char* const attributes[] = {"minecraft:generic.max_health", "minecraft:generic.movement_speed",
+                                           "minecraft:generic.follow_range", "minecraft:generic.armor"};
+
+  nbt::List entities(nbt::Type::COMPOUND);
+  for (int32_t i = 0; i < 4096; i++) {
+    nbt::Compound entity;
+    entity["id"] = pick(rng, mobs);
+
+    nbt::List pos(nbt::Type::DOUBLE), motion(nbt::Type::DOUBLE), rotation(nbt::Type::FLOAT);
+    for (int j = 0; j < 3; j++) {
+      pos.pushBack(static_cast<double>(pick(rng, 1 << 20)) / 64.0);
+      motion.pushBack(static_cast<double>(pick(rng, 1024)) / 8192.0);
+    }
+    rotation.pushBack(static_cast<float>(pick(rng, 360)));
+    rotation.pushBack(static_cast<float>(pick(rng, 180)) - 90.0F);
+    entity["Pos"] = std::move(pos);
+    entity["Motion"] = std::move(motion);
+    entity["Rotation"] = std::move(rotation);
+
+    entity["Health"] = static_cast<float>(1 + pick(rng, 20));
+    entity["Air"] = static_cast<int16_t>(300);
+    entity["Fire"] = static_cast<int16_t>(-1);
+    entity["FallDistance"] = 0.0F;
+    entity["OnGround"] = static_cast<int8_t>(pick(rng, 2));
+    entity["PortalCooldown"] = 0;
+    entity["UUID"] = std::vector<int32_t>{static_cast<int32_t>(rng()), static_cast<int32_t>(rng()),
+                                          static_cast<int32_t>(rng()), static_cast<int32_t>(rng())};
+
+    nbt::List modifiers(nbt::Type::COMPOUND);
+    for (uint32_t j = 0, count = 1 + pick(rng, 4); j < count; j++) {
+      nbt::Compound attribute;
+      attribute["Name"] = attributes[j];
+      attribute["Base"] = static_cast<double>(pick(rng, 64));
+      modifiers.pushBack(std::move(attribute));
+    }
+    entity["Attributes"] = std::move(modifiers);
+
+    nbt::List armor(nbt::Type::COMPOUND);
+    for (int j = 0; j < 4; j++) armor.pushBack(nbt::Compound());
+    entity["ArmorItems"] = std::move(armor);
+    entities.pushBack(std::move(entity));
+  }
+
+  nbt::Compound document;
+  document["DataVersion"] = 3700;
+  document["Position"] = std::vector<int32_t>{static_cast<int32_t>(pick(rng, 64)), static_cast<int32_t>(pick(rng, 64))};
+  document["Entities"] = std::move(entities);
+  return document;
+}
+
+nbt::Compound createDeep(std::mt19937& rng) {
+  nbt::List chains(nbt::Type::COMPOUND);
+  for (int i = 0; i < 16; i++) {
+    nbt::Compound level;
+    level["leaf"] = randomLong(rng);
+
+    // Every other level wraps the compound below in a list of one, so both containers nest
+    for (int32_t depth = 511; depth >= 0; depth--) {
+      nbt::Compound parent;
+      parent["depth"] = depth;
+      if (depth % 2 == 0) {
+        nbt::List list(nbt::Type::COMPOUND);
+        list.pushBack(std::move(level));
+        parent["next"] = std::move(list);
+      } else {
+        parent["next"] = std::move(level);
+      }
+      level = std::move(parent);
+    }
+    chains.pushBack(std::move(level));
+  }
+
+  nbt::Compound document;
+  document["chains"] = std::move(chains);
+  return document;
+}
+
+nbt::Compound createStrings(std::mt19937& rng) {
+  static const char* const items[] = {"minecraft:diamond_sword", "minecraft:written_book", "minecraft:enchanted_book",
+                                      "minecraft:netherite_pickaxe", "minecraft:elytra", "minecraft:shulker_box"};
+  static const char* const words[] = {"the", "ancient", "blade", "of", "forgotten", "kings", "forged", "in", "fire",
+                                      "Schwert", "épée", "légendaire", "剣", "Ключ", "cursed", "shimmering"};
+  static const char* const enchantments[] = {"minecraft:sharpness", "minecraft:unbreaking", "minecraft:mending",
+                                             "minecraft:fire_aspect", "minecraft:efficiency", "minecraft:looting"};
+
+  auto sentence = [&](uint32_t length) {
+    std::string text;
+    for (uint32_t i = 0; i < length; i++) {
+      if (i != 0) text += ' ';
+      text += pick(rng, words);
+    }
+    return text;
+  };
+
+  nbt::List chests(nbt::Type::COMPOUND);
+  for (int32_t chest = 0; chest < 128; chest++) {
+    nbt::List contents(nbt::Type::COMPOUND);
+    for (int32_t slot = 0; slot < 27; slot++) {
+      nbt::Compound display;
+      display["Name"] = "{\"text\":\"" + sentence(2 + pick(rng, 4)) + "\",\"italic\":false}";
+      nbt::List lore(nbt::Type::STRING);
+      for (uint32_t i = 0, count = 1 + pick(rng, 5); i < count; i++) {
+        lore.emplaceBack("{\"text\":\"" + sentence(4 + pick(rng, 8)) + "\"}");
+      }
+      display["Lore"] = std::move(lore);
+
+      nbt::Compound tag;
+      tag["display"] = std::move(display);
+      nbt::List enchanted(nbt::Type::COMPOUND);
+      for (uint32_t i = 0, count = pick(rng, 4); i < count; i++) {
+        nbt::Compound enchantment;
+        enchantment["id"] = pick(rng, enchantments);
+        enchantment["lvl"] = static_cast<int16_t>(1 + pick(rng, 5));
+        enchanted.pushBack(std::move(enchantment));
+      }
+      tag["Enchantments"] = std::move(enchanted);
+
+      const char* id = pick(rng, items);
+      if (std::string_view(id) == "minecraft:written_book") {
+        tag["title"] = sentence(3);
+        tag["author"] = sentence(1);
+        nbt::List pages(nbt::Type::STRING);
+        for (uint32_t i = 0, count = 1 + pick(rng, 8); i < count; i++) pages.emplaceBack(sentence(40));
+        tag["pages"] = std::move(pages);
+      }
+
+      nbt::Compound item;
+      item["Slot"] = static_cast<int8_t>(slot);
+      item["id"] = id;
+      item["Count"] = static_cast<int8_t>(1);
+      item["tag"] = std::move(tag);
+      contents.pushBack(std::move(item));
+    }
+
+    nbt::Compound entity;
+    entity["id"] = "minecraft:chest";
+    entity["CustomName"] = "{\"text\":\"" + sentence(2) + "\"}";
+    entity["Items"] = std::move(contents);
+    chests.pushBack(std::move(entity));
+  }
+
+  nbt::Compound document;
+  document["block_entities"] = std::move(chests);
+  return document;
+}
+
+const char* getCorpusName(Corpus corpus) {
+  switch (corpus) {
+    case Corpus::CHUNK: return "chunk";
+    case Corpus::ENTITIES: return "entities";
+    case Corpus::DEEP: return "deep";
+    default: return "strings";
+  }
+}
+
+nbt::Compound createCorpus(Corpus corpus) {
+  std::mt19937 rng(0x4E425400U + static_cast<uint32_t>(corpus));
+  switch (corpus) {
+    case Corpus::CHUNK: return createChunk(rng);
+    case Corpus::ENTITIES: return createEntities(rng);
+    case Corpus::DEEP: return createDeep(rng);
+    default: return createStrings(rng);
+  }
+}
+
+size_t countTags(const nbt::Compound& compound) {
+  size_t count = 0;
+  for (const auto& pair : compound) count += countTags(pair.second);
+  return count;
+}
+
+size_t countTags(const nbt::Value& value) {
+  switch (value.getType()) {
+    case nbt::Type::COMPOUND: return 1 + countTags(value.getCompound());
+    case nbt::Type::LIST: {
+      const nbt::List& list = value.getList();
+      if (list.hasTypedStorage()) return 1 + list.size();
+
+      size_t count = 1;
+      for (const auto& element : list) count += countTags(element);
+      return count;
+    }
+    default: return 1;
+  }
+}
+
+void* CountingResource::do_allocate(size_t bytes, size_t alignment) {
+  m_Allocations++;
+  m_Bytes += bytes;
+  return m_Upstream->allocate(bytes, alignment);
+}
+
+void CountingResource::do_deallocate(void* pointer, size_t bytes, size_t alignment) {
+  m_Deallocations++;
+  m_Bytes -= bytes;
+  m_Upstream->deallocate(pointer, bytes, alignment);
+}
+
+bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
@@ -0,0 +1,52 @@
+#ifndef NBT_BENCH_CORPUS_HPP_
+#define NBT_BENCH_CORPUS_HPP_
+
+#include <cstddef>
+#include <memory_resource>
+
+#include "nbt/nbt.hpp"
+
+/**
+ * Synthetic documents shaped like the ones the library is used on. They are generated from a fixed seed, using only the
+ * raw output of std::mt19937, so every platform and release benchmarks the same bytes.
+ */
+enum class Corpus {
+  CHUNK,     // An anvil chunk: 24 sections of packed LONG_ARRAY block states with their palettes, light and heightmaps
+  ENTITIES,  // 4096 mob compounds, as in an entity chunk or a server's entity dump
+  DEEP,      // Compounds and lists nested 512 levels deep
+  STRINGS    // Chests full of named, enchanted items with lore, mostly string payloads
+};
+
+constexpr int CORPUS_COUNT = 4;
+
+const char* getCorpusName(Corpus corpus);
+nbt::Compound createCorpus(Corpus corpus);
+
+/**
+ * @return Returns the number of tags in value, itself included, counting every list element as a tag.
+ */
+size_t countTags(const nbt::Value& value);
+size_t countTags(const nbt::Compound& compound);
+
+/**
+ * Counts the allocations made through it and the bytes they hold, forwarding them to upstream.
+ */
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) : m_Upstream(upstream) {}
+
+  [[nodiscard]] size_t getAllocations() const { return m_Allocations; }
+  [[nodiscard]] size_t getDeallocations() const { return m_Deallocations; }
+  [[nodiscard]] size_t getBytes() const { return m_Bytes; }
+ private:
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+  std::pmr::memory_resource* m_Upstream;
+  size_t m_Allocations = 0;
+  size_t m_Deallocations = 0;
+  size_t m_Bytes = 0;  // Allocated and not yet deallocated
+};
+
+#endif //NBT_BENCH_CORPUS_HPP_
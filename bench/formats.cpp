@@ -0,0 +1,61 @@
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "nbt/nbt.hpp"
+
+/**
+ * Every variant of the format decoding and encoding the same entity list, compared against the Java path.
+ */
+nbt::Compound createEntities() {
+  nbt::List entities(nbt::Type::COMPOUND);
+  for (int32_t i = 0; i < 2048; i++) {
+    nbt::Compound entity;
+    entity["id"] = "minecraft:zombie";
+    entity["Health"] = 20.0F;
+    entity["Age"] = i;
+    entity["UUID"] = std::vector<int32_t>{i, -i, i * 31, i ^ 0x5555};
+    entity["LastSeen"] = static_cast<int64_t>(1700000000000LL + i);
+
+    nbt::List pos(nbt::Type::DOUBLE);
+    for (double coordinate : {i * 0.5, 64.0, i * -0.25}) pos.pushBack(coordinate);
+    entity["Pos"] = std::move(pos);
+    entities.pushBack(std::move(entity));
+  }
+
+  nbt::Compound document;
+  document["Entities"] = std::move(entities);
+  document["Heightmap"] = std::vector<int64_t>(37, 0x0102030405060708LL);
+  return document;
+}
+
+void BM_ParseFormat(benchmark::State& state) {
+  auto format = static_cast<nbt::Format>(state.range(0));
+  auto buffer = nbt::Writer::writeToBuffer(createEntities(), format);
+  nbt::ReaderOptions options;
+  options.format = format;
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(nbt::Reader::parse(buffer.data(), buffer.size(), options));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buffer.size()));
+}
+
+void BM_WriteFormat(benchmark::State& state) {
+  auto format = static_cast<nbt::Format>(state.range(0));
+  nbt::Compound document = createEntities();
+  std::vector<char> buffer;
+
+  for (auto _ : state) {
+    nbt::Writer::writeToBuffer(document, buffer, format);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buffer.size()));
+}
+
+#define NBT_FORMATS ->Arg(static_cast<int>(nbt::Format::JAVA))->Arg(static_cast<int>(nbt::Format::JAVA_NETWORK)) \
+    ->Arg(static_cast<int>(nbt::Format::BEDROCK))->Arg(static_cast<int>(nbt::Format::BEDROCK_NETWORK))
+
+BENCHMARK(BM_ParseFormat) NBT_FORMATS;
+BENCHMARK(BM_WriteFormat) NBT_FORMATS;
@@ -0,0 +1,159 @@
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "corpus.hpp"
+#include "nbt/nbt.hpp"
+
+/**
+ * Throughput of the whole document lifecycle on every corpus. Besides bytes/s of the encoded document, each run reports
+ * tags/s and the allocations made per document, counted on the default memory resource. Parsing also reports the
+ * memory footprint of the resulting tree.
+ */
+struct Sample {
+  nbt::Compound document;
+  std::vector<char> buffer;
+  size_t tags;
+};
+
+const Sample& getSample(int64_t index) {
+  static std::unique_ptr<Sample> samples[CORPUS_COUNT];
+
+  auto& sample = samples[index];
+  if (sample == nullptr) {
+    nbt::Compound document = createCorpus(static_cast<Corpus>(index));
+    auto buffer = nbt::Writer::writeToBuffer(document);
+    size_t tags = countTags(document);
+    sample = std::make_unique<Sample>(Sample{std::move(document), std::move(buffer), tags});
+  }
+  return *sample;
+}
+
+/**
+ * Makes resource the default memory resource for its lifetime.
+ */
+class ScopedDefaultResource {
+ public:
+  explicit ScopedDefaultResource(std::pmr::memory_resource* resource) : m_Previous(std::pmr::set_default_resource(resource)) {}
+  ~ScopedDefaultResource() { std::pmr::set_default_resource(m_Previous); }
+
+  ScopedDefaultResource(const ScopedDefaultResource&) = delete;
+  ScopedDefaultResource& operator=(const ScopedDefaultResource&) = delete;
+ private:
+  std::pmr::memory_resource* m_Previous;
+};
+
+void report(benchmark::State& state, const Sample& sample, const char* counter, size_t count) {
+  auto iterations = static_cast<double>(state.iterations());
+  state.SetLabel(getCorpusName(static_cast<Corpus>(state.range(0))));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * sample.buffer.size()));
+  state.counters["tags/s"] = benchmark::Counter(iterations * static_cast<double>(sample.tags), benchmark::Counter::kIsRate);
+  state.counters[counter] = benchmark::Counter(static_cast<double>(count), benchmark::Counter::kAvgIterations);
+}
+
+void BM_Parse(benchmark::State& state) {
+  const Sample& sample = getSample(state.range(0));
+  CountingResource resource;
+  ScopedDefaultResource scope(&resource);
+
+  std::optional<nbt::Compound> document;
+  size_t footprint = 0;
+  for (auto _ : state) {
+    document.emplace(nbt::Reader::parse(sample.buffer.data(), sample.buffer.size()));
+    state.PauseTiming();
+    footprint = resource.getBytes();
+    document.reset();
+    state.ResumeTiming();
+  }
+  report(state, sample, "allocs/doc", resource.getAllocations());
+  state.counters["tree_bytes"] = static_cast<double>(footprint);
+}
+
+void BM_Write(benchmark::State& state) {
+  const Sample& sample = getSample(state.range(0));
+  CountingResource resource;
+  ScopedDefaultResource scope(&resource);
+
+  std::vector<char> buffer;
+  for (auto _ : state) {
+    nbt::Writer::writeToBuffer(sample.document, buffer);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  report(state, sample, "allocs/doc", resource.getAllocations());
+}
+
+void BM_Copy(benchmark::State& state) {
+  const Sample& sample = getSample(state.range(0));
+  CountingResource resource;
+  ScopedDefaultResource scope(&resource);
+
+  std::optional<nbt::Compound> copy;
+  for (auto _ : state) {
+    copy.emplace(sample.document);
+    state.PauseTiming();
+    copy.reset();
+    state.ResumeTiming();
+  }
+  report(state, sample, "allocs/doc", resource.getAllocations());
+}
+
+/**
+ * Copy-on-write snapshot of the document, see Value::share().
+ */
+void BM_Share(benchmark::State& state) {
+  const Sample& sample = getSample(state.range(0));
+  CountingResource resource;
+  ScopedDefaultResource scope(&resource);
+
+  std::optional<nbt::Compound> copy;
+  for (auto _ : state) {
+    copy.emplace(sample.document.share());
+    state.PauseTiming();
+    copy.reset();
+    state.ResumeTiming();
+  }
+  report(state, sample, "allocs/doc", resource.getAllocations());
+}
+
+void BM_Compare(benchmark::State& state) {
+  const Sample& sample = getSample(state.range(0));
+  nbt::Compound copy = sample.document;  // A distinct tree, equal compounds compare every tag
+
+  CountingResource resource;
+  ScopedDefaultResource scope(&resource);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(copy == sample.document);
+  }
+  report(state, sample, "allocs/doc", resource.getAllocations());
+}
+
+void BM_Destroy(benchmark::State& state) {
+  const Sample& sample = getSample(state.range(0));
+  CountingResource resource;
+  ScopedDefaultResource scope(&resource);
+
+  std::optional<nbt::Compound> copy;
+  size_t deallocations = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    copy.emplace(sample.document);
+    size_t before = resource.getDeallocations();
+    state.ResumeTiming();
+
+    copy.reset();
+
+    state.PauseTiming();
+    deallocations += resource.getDeallocations() - before;
+    state.ResumeTiming();
+  }
+  report(state, sample, "frees/doc", deallocations);
+}
+
+BENCHMARK(BM_Parse)->DenseRange(0, CORPUS_COUNT - 1);
+BENCHMARK(BM_Write)->DenseRange(0, CORPUS_COUNT - 1);
+BENCHMARK(BM_Copy)->DenseRange(0, CORPUS_COUNT - 1);
+BENCHMARK(BM_Share)->DenseRange(0, CORPUS_COUNT - 1);
+BENCHMARK(BM_Compare)->DenseRange(0, CORPUS_COUNT - 1);
+BENCHMARK(BM_Destroy)->DenseRange(0, CORPUS_COUNT - 1);
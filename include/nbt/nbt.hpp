@@ -36,7 +36,16 @@ using namespace defaults;
 
 #include "nbt_type.hpp"
 
+#include "nbt_batch.hpp"
+#include "nbt_diff.hpp"
+#include "nbt_index.hpp"
+#include "nbt_path.hpp"
+#include "nbt_push_parser.hpp"
 #include "nbt_reader.hpp"
+#include "nbt_region.hpp"
+#include "nbt_thread_pool.hpp"
+#include "nbt_view.hpp"
+#include "nbt_visitor.hpp"
 #include "nbt_writer.hpp"
 
 #endif //NBT_INCLUDE_NBT_NBT_HPP_
@@ -0,0 +1,63 @@
+#ifndef NBT_INCLUDE_NBT_NBT_BATCH_HPP_
+#define NBT_INCLUDE_NBT_NBT_BATCH_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+#include "nbt_reader.hpp"
+#include "nbt_thread_pool.hpp"
+#include "nbt_type.hpp"
+
+namespace nbt {
+
+struct BatchStats {
+  size_t documents = 0;
+  size_t bytes = 0;
+  size_t arenas = 0;  // Slots, each a pool task with its own arena, that parsed at least one document
+  double seconds = 0;
+
+  [[nodiscard]] double getDocumentsPerSecond() const { return seconds > 0 ? static_cast<double>(documents) / seconds : 0; }
+  [[nodiscard]] double getBytesPerSecond() const { return seconds > 0 ? static_cast<double>(bytes) / seconds : 0; }
+};
+
+/**
+ * Parses batches of small, independent documents on a thread pool. Every thread allocates from its own arena, so the
+ * threads never contend on an allocator, and the arenas are recycled by the next batch. The parsed documents live in
+ * those arenas and are only valid until the next call to parse() or the reader's destruction.
+ */
+class BatchReader {
+ public:
+  explicit BatchReader(ThreadPool& pool = ThreadPool::global());
+  ~BatchReader();
+
+  BatchReader(const BatchReader&) = delete;
+  BatchReader& operator=(const BatchReader&) = delete;
+
+  /**
+   * Parses every document, keeping their order. options.resource is replaced by the per-thread arenas, options.pool is
+   * ignored, as every document is parsed on a single thread, and options.keyTable must be thread safe if set. The first
+   * failure is rethrown once the batch has finished.
+   */
+  const std::vector<Compound>& parse(const std::vector<std::string_view>& documents, const ReaderOptions& options = {});
+
+  [[nodiscard]] const std::vector<Compound>& getDocuments() const;
+
+  /**
+   * @return Returns the statistics of the last batch.
+   */
+  [[nodiscard]] const BatchStats& getStats() const;
+ private:
+  struct Slot;
+
+  ThreadPool& m_Pool;
+  std::vector<std::unique_ptr<Slot>> m_Slots;
+  std::vector<Compound> m_Documents;
+  BatchStats m_Stats;
+};
+
+} // namespace nbt
+
+#endif //NBT_INCLUDE_NBT_NBT_BATCH_HPP_
@@ -0,0 +1,78 @@
+#ifndef NBT_INCLUDE_NBT_NBT_DIFF_HPP_
+#define NBT_INCLUDE_NBT_NBT_DIFF_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "nbt_reader.hpp"
+#include "nbt_type.hpp"
+
+namespace nbt {
+
+/**
+ * Edit script that turns one compound into another, produced by diff() and replayed by apply(). Each edit addresses a
+ * tag by its path from the patched compound, one compound key or list index per segment.
+ */
+class Patch {
+ public:
+  enum class Operation : uint8_t {
+    SET,     // Sets the tag at path, inserting it into its compound or replacing a list element
+    REMOVE,  // Removes the tag at path from its compound
+    SPLICE   // Replaces count elements of the array or list at path, from offset on, with the elements of value
+  };
+
+  struct Segment {
+    static constexpr size_t KEY = SIZE_MAX;
+
+    std::string key;  // Compound key, unused for list indices
+    size_t index;     // KEY for compound keys, otherwise a list index
+
+    [[nodiscard]] bool isKey() const { return index == KEY; }
+  };
+
+  struct Edit {
+    Operation operation;
+    std::vector<Segment> path;
+    Value value;        // The tag for SET, the inserted elements, as an array or list, for SPLICE
+    size_t offset = 0;  // SPLICE only
+    size_t count = 0;
+  };
+
+  void add(Edit edit);
+
+  [[nodiscard]] const std::vector<Edit>& getEdits() const;
+  [[nodiscard]] bool empty() const;
+
+  /**
+   * Encodes the patch: a varint edit count, then per edit its operation byte, a varint segment count and the segments
+   * (varint key length << 1 followed by the key, or varint index << 1 | 1), the varint offset and count of splices, and
+   * the type and payload of the value, encoded as in Java Edition documents.
+   */
+  [[nodiscard]] std::vector<char> encode() const;
+
+  /**
+   * Decodes an encoded patch, enforcing limits on its values as Reader::parse does.
+   */
+  static Patch decode(const void* data, size_t length, const ReaderLimits& limits = {});
+ private:
+  std::vector<Edit> m_Edits;
+};
+
+/**
+ * Computes the edits that turn a into b. Arrays and lists of primitives are patched by the ranges of elements that
+ * changed, lists of other tags element by element. Subtrees that a and b share through Value::share() are skipped
+ * without being compared, so diffing a tree against a snapshot of itself only walks the paths modified since.
+ */
+Patch diff(const Compound& a, const Compound& b);
+
+/**
+ * Applies patch to compound, which must equal the compound the patch was computed from for the result to equal its
+ * target. Fails if a path does not resolve.
+ */
+void apply(Compound& compound, const Patch& patch);
+
+} // namespace nbt
+
+#endif //NBT_INCLUDE_NBT_NBT_DIFF_HPP_
@@ -0,0 +1,92 @@
+#ifndef NBT_INCLUDE_NBT_NBT_INDEX_HPP_
+#define NBT_INCLUDE_NBT_NBT_INDEX_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "nbt_type.hpp"
+#include "nbt_view.hpp"
+
+namespace nbt {
+
+/**
+ * Offsets of every compound entry and list element of an encoded document, built in a single pass so that repeated
+ * lookups jump straight to a tag instead of re-scanning the buffer. The buffer must outlive the index.
+ */
+class OffsetIndex {
+ public:
+  static constexpr uint32_t FIXED_ELEMENTS = UINT32_MAX;
+
+  struct Entry {
+    uint32_t name;      // Offset of the name bytes
+    uint32_t payload;   // Offset of the payload
+    uint32_t size;      // Payload length
+    uint32_t children;  // Index of the first child entry, or FIXED_ELEMENTS for lists of fixed size elements
+    uint32_t count;     // Number of compound entries or list elements
+    uint16_t nameLength;
+    Type type;
+  };
+
+  /**
+   * Handle to an indexed tag. Lookups of missing tags return an empty node.
+   */
+  class Node {
+   public:
+    Node() : m_Index(nullptr), m_Entry(0), m_Element(0) {}
+    Node(const OffsetIndex* index, uint32_t entry, uint32_t element) : m_Index(index), m_Entry(entry), m_Element(element) {}
+
+    explicit operator bool() const { return m_Index != nullptr; }
+
+    [[nodiscard]] Type getType() const;
+    [[nodiscard]] std::string_view getName() const;
+    [[nodiscard]] View getView() const;
+
+    /**
+     * @return Returns the compound entry with the given raw name.
+     */
+    Node operator[](std::string_view key) const;
+
+    /**
+     * @return Returns the list element at index.
+     */
+    Node operator[](size_t index) const;
+
+    /**
+     * @return Returns the number of compound entries or list elements.
+     */
+    [[nodiscard]] size_t size() const;
+   private:
+    static constexpr uint32_t NO_ELEMENT = UINT32_MAX;
+
+    friend class OffsetIndex;
+
+    const OffsetIndex* m_Index;
+    uint32_t m_Entry;
+    uint32_t m_Element;  // Element of a fixed size list entry, or NO_ELEMENT
+  };
+
+  OffsetIndex() : m_Data(nullptr), m_Root(0) {}
+  OffsetIndex(const void* data, size_t length);
+
+  /**
+   * @return Returns the document, a compound of its root tags.
+   */
+  [[nodiscard]] Node getRoot() const;
+
+  /**
+   * @return Returns the tag at a path such as "Level.Sections[2].Y", or an empty node.
+   */
+  [[nodiscard]] Node find(std::string_view path) const;
+
+  [[nodiscard]] const std::vector<Entry>& getEntries() const;
+ private:
+  const char* m_Data;
+  std::vector<Entry> m_Entries;
+  uint32_t m_Root;
+};
+
+} // namespace nbt
+
+#endif //NBT_INCLUDE_NBT_NBT_INDEX_HPP_
@@ -0,0 +1,168 @@
+#ifndef NBT_INCLUDE_NBT_NBT_KEY_HPP_
+#define NBT_INCLUDE_NBT_NBT_KEY_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace nbt {
+
+class KeyTable;
+
+/**
+ * Immutable compound key with a precomputed hash. Short keys are stored inline, longer keys in a reference counted
+ * atom. Keys interned through a KeyTable always share the table's atom, so equal interned keys compare by pointer and
+ * copying them is free.
+ */
+class Key {
+ public:
+  Key() noexcept : m_Inline(), m_Hash(EMPTY_HASH), m_Length(0) {}
+  explicit Key(std::string_view key, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+  Key(const Key& rhs) noexcept : m_Inline(), m_Hash(rhs.m_Hash), m_Length(rhs.m_Length) {
+    std::memcpy(m_Inline, rhs.m_Inline, INLINE_CAPACITY);
+    if (m_Length == ATOM) retain(m_Atom);
+  }
+
+  Key(Key&& rhs) noexcept : m_Inline(), m_Hash(rhs.m_Hash), m_Length(rhs.m_Length) {
+    std::memcpy(m_Inline, rhs.m_Inline, INLINE_CAPACITY);
+    if (m_Length == ATOM) rhs.clear();
+  }
+
+  ~Key() {
+    if (m_Length == ATOM) release(m_Atom);
+  }
+
+  Key& operator=(const Key& rhs) noexcept;
+  Key& operator=(Key&& rhs) noexcept;
+
+  bool operator==(const Key& rhs) const {
+    if (m_Length == ATOM && rhs.m_Length == ATOM && m_Atom == rhs.m_Atom) return true;
+    return m_Hash == rhs.m_Hash && view() == rhs.view();
+  }
+
+  bool operator!=(const Key& rhs) const { return !operator==(rhs); }
+
+  operator std::string_view() const { return view(); }  //NOLINT
+
+  [[nodiscard]] std::string_view view() const {
+    if (m_Length == ATOM) return {m_Atom->data(), m_Atom->length};
+    return {m_Inline, m_Length};
+  }
+
+  [[nodiscard]] const char* data() const { return view().data(); }
+  [[nodiscard]] size_t size() const { return view().size(); }
+  [[nodiscard]] bool empty() const { return size() == 0; }
+
+  [[nodiscard]] uint32_t hash() const { return m_Hash; }
+
+  /**
+   * @return Returns whether the key is shared through a KeyTable.
+   */
+  [[nodiscard]] bool isInterned() const { return m_Length == ATOM && m_Atom->interned; }
+
+  static uint32_t hashOf(std::string_view key) {
+    if (key.empty()) return EMPTY_HASH;
+    return static_cast<uint32_t>(std::hash<std::string_view>()(key));
+  }
+ private:
+  friend class KeyTable;
+
+  struct Atom {
+    std::atomic<uint32_t> references;  // IMMORTAL for interned atoms, which are owned by their table
+    uint32_t length;
+    uint32_t hash;
+    bool interned;
+    std::pmr::memory_resource* resource;
+
+    [[nodiscard]] const char* data() const { return reinterpret_cast<const char*>(this + 1); }
+  };
+
+  static constexpr uint32_t EMPTY_HASH = 0;
+  static constexpr uint32_t IMMORTAL = UINT32_MAX;
+  static constexpr uint8_t ATOM = UINT8_MAX;
+  static constexpr size_t INLINE_CAPACITY = 16;
+
+  explicit Key(const Atom* atom) noexcept;
+
+  static Atom* createAtom(std::string_view key, uint32_t hash, std::pmr::memory_resource* resource);
+  static void destroy(const Atom* atom);
+
+  static void retain(const Atom* atom) {
+    auto& references = const_cast<Atom*>(atom)->references;
+    if (references.load(std::memory_order_relaxed) != IMMORTAL) references.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  static void release(const Atom* atom) {
+    auto& references = const_cast<Atom*>(atom)->references;
+    if (references.load(std::memory_order_relaxed) == IMMORTAL) return;
+    if (references.fetch_sub(1, std::memory_order_acq_rel) == 1) destroy(atom);
+  }
+
+  void clear() {
+    m_Length = 0;
+    m_Hash = EMPTY_HASH;
+  }
+
+  union {
+    const Atom* m_Atom;
+    char m_Inline[INLINE_CAPACITY];
+  };
+  uint32_t m_Hash;
+  uint8_t m_Length;  // Inline length, or ATOM
+};
+
+inline bool operator==(const Key& lhs, std::string_view rhs) { return lhs.view() == rhs; }
+inline bool operator==(std::string_view lhs, const Key& rhs) { return lhs == rhs.view(); }
+inline bool operator!=(const Key& lhs, std::string_view rhs) { return lhs.view() != rhs; }
+inline bool operator!=(std::string_view lhs, const Key& rhs) { return lhs != rhs.view(); }
+
+/**
+ * Interning table for compound keys. Pass one to the Reader to share key storage between all parsed compounds. Interned
+ * keys are owned by the table, so it must outlive every Key it returned.
+ */
+class KeyTable {
+ public:
+  /**
+   * @param synchronized Whether intern() may be called concurrently from several threads. Lookups of keys already in
+   * the table never lock.
+   */
+  explicit KeyTable(bool synchronized = false, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+  ~KeyTable();
+
+  KeyTable(const KeyTable&) = delete;
+  KeyTable& operator=(const KeyTable&) = delete;
+
+  Key intern(std::string_view key);
+
+  [[nodiscard]] size_t size() const;
+
+  /**
+   * @return Returns the process wide table. It is synchronized and never destroyed.
+   */
+  static KeyTable& global();
+ private:
+  struct Slots;
+
+  [[nodiscard]] const Key::Atom* find(const Slots& slots, std::string_view key, uint32_t hash) const;
+  const Key::Atom* insert(std::string_view key, uint32_t hash);
+  void grow();
+
+  std::vector<std::unique_ptr<Slots>> m_Generations;  // Replaced slot arrays are kept alive for concurrent readers
+  std::atomic<Slots*> m_Slots;
+  size_t m_Size;
+  std::mutex m_Mutex;
+  bool m_Synchronized;
+  std::pmr::memory_resource* m_Resource;
+};
+
+} // namespace nbt
+
+#endif //NBT_INCLUDE_NBT_NBT_KEY_HPP_
@@ -0,0 +1,63 @@
+#ifndef NBT_INCLUDE_NBT_NBT_PATH_HPP_
+#define NBT_INCLUDE_NBT_NBT_PATH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nbt {
+
+/**
+ * Set of tag paths for selective parsing, such as "Level.xPos" or "Level.Sections[*].BlockStates". Segments are compound
+ * keys separated by '.', each optionally followed by list selectors: "[*]" for every element or "[n]" for the element at
+ * index n. Selected lists keep the order of their selected elements, not their indices.
+ */
+class PathSet {
+ public:
+  /**
+   * Compiled form of the set, a tree that the reader walks alongside the document.
+   */
+  struct Node {
+    static constexpr int64_t ALL = -1;
+    static constexpr int64_t KEY = -2;
+
+    std::string name;  // Compound key, unused for list selectors
+    int64_t index;     // KEY for compound keys, otherwise a list selector: ALL or an element index
+    bool selected;     // The whole tag is materialized
+    std::vector<Node> children;
+
+    [[nodiscard]] bool isListSelector() const { return index != KEY; }
+    [[nodiscard]] const Node* findKey(std::string_view key) const;
+    [[nodiscard]] const Node* findIndex(size_t index) const;
+  };
+
+  /**
+   * Segment of a parsed path, see parse().
+   */
+  struct Segment {
+    std::string_view name;  // Compound key, empty for list selectors
+    int64_t index;          // Node::KEY for compound keys, otherwise Node::ALL or an element index
+  };
+
+  PathSet();
+  PathSet(std::initializer_list<std::string_view> paths);
+
+  /**
+   * Splits a path into its compound keys and list selectors, failing if it is malformed. Names view into path.
+   */
+  static std::vector<Segment> parse(std::string_view path);
+
+  void add(std::string_view path);
+
+  [[nodiscard]] const Node& getRoot() const;
+  [[nodiscard]] bool empty() const;
+ private:
+  Node m_Root;
+};
+
+} // namespace nbt
+
+#endif //NBT_INCLUDE_NBT_NBT_PATH_HPP_
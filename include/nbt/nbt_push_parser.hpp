@@ -0,0 +1,118 @@
+#ifndef NBT_INCLUDE_NBT_NBT_PUSH_PARSER_HPP_
+#define NBT_INCLUDE_NBT_NBT_PUSH_PARSER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "nbt_key.hpp"
+#include "nbt_reader.hpp"
+#include "nbt_type.hpp"
+
+namespace nbt {
+
+class Budget;
+
+/**
+ * Decodes one uncompressed document, a single named root tag, from bytes handed over in fragments of any size, e.g. as
+ * they arrive on a non-blocking socket. The parser keeps its position in an explicit stack of open lists and compounds,
+ * so it never blocks, never recurses and only holds the part of the tree decoded so far, plus at most one partial name,
+ * string or fixed size field.
+ */
+class PushParser {
+ public:
+  enum class Status {
+    NEED_MORE_DATA,
+    DONE,
+    INVALID
+  };
+
+  /**
+   * Uses options.resource, options.keyTable and options.limits, paths and pool are ignored.
+   */
+  explicit PushParser(const ReaderOptions& options = {});
+  ~PushParser();
+
+  PushParser(const PushParser&) = delete;
+  PushParser& operator=(const PushParser&) = delete;
+
+  /**
+   * Decodes as much of data as possible. Once the document is complete, the rest of data is left unconsumed for the
+   * next message (see getConsumed()) and further calls return DONE until takeDocument() or reset(). A malformed
+   * document makes this and every further call return INVALID until reset().
+   */
+  Status feed(const void* data, size_t length);
+
+  /**
+   * @return Returns the number of bytes the last feed() consumed.
+   */
+  [[nodiscard]] size_t getConsumed() const;
+
+  [[nodiscard]] Status getStatus() const;
+  [[nodiscard]] const std::string& getError() const;
+
+  /**
+   * Hands over the document after feed() returned DONE, following config::omitRootTag() like Reader::parse, and resets
+   * the parser for the next document.
+   */
+  Compound takeDocument();
+
+  void reset();
+ private:
+  enum class State : uint8_t {
+    TYPE,
+    NAME_LENGTH,
+    NAME,
+    PAYLOAD,
+    STRING_LENGTH,
+    STRING,
+    ARRAY_LENGTH,
+    ELEMENTS,
+    LIST_HEADER,
+    DONE
+  };
+
+  struct Frame;
+
+  bool step();
+  void beginPayload();
+  void open(Value container, size_t remaining);
+  void close();
+  void deliver(Key key, Value value);
+  bool readElements();
+  template<typename T> bool readElements(std::pmr::vector<T>& values);
+  const char* take(size_t size);
+  bool fill(char* destination, size_t length);
+  [[nodiscard]] size_t available() const { return static_cast<size_t>(m_End - m_Position); }
+
+  std::pmr::memory_resource* m_Resource;
+  KeyTable* m_Keys;
+  ReaderLimits m_Limits;
+  std::unique_ptr<Budget> m_Budget;
+
+  Status m_Status;
+  State m_State;
+  std::string m_Error;
+  size_t m_Consumed;
+
+  const char* m_Position;  // Fragment being fed
+  const char* m_End;
+
+  std::vector<Frame> m_Stack;  // The document, then every open list and compound
+  Type m_Type;                 // Type of the tag being read
+  Key m_Key;                   // Name of the tag being read, if its parent is a compound
+  std::string m_Name;
+  String m_String;
+  Value m_Value;               // Array being read
+  size_t m_Remaining;          // Elements left in the array or primitive list being read
+  size_t m_Filled;             // Bytes of m_Name or m_String received so far
+  char m_Token[8];             // Partial fixed size field, split across fragments
+  size_t m_TokenSize;
+};
+
+} // namespace nbt
+
+#endif //NBT_INCLUDE_NBT_NBT_PUSH_PARSER_HPP_
@@ -1,17 +1,151 @@
 #ifndef NBT_INCLUDE_NBT_NBT_READER_HPP_
 #define NBT_INCLUDE_NBT_NBT_READER_HPP_
 
+#include "nbt_path.hpp"
+#include "nbt_thread_pool.hpp"
 #include "nbt_type.hpp"
+#include "nbt_view.hpp"
+#include "nbt_visitor.hpp"
 
-#include <ostream>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <memory_resource>
+#include <string>
 
 namespace nbt {
 
+/**
+ * Bounds on what decoding a document may allocate, for untrusted input such as network packets. Lengths are checked
+ * before anything is allocated for them, and decoding fails with a std::runtime_error as soon as a limit is exceeded.
+ */
+struct ReaderLimits {
+  size_t maxBytes = SIZE_MAX;        // Bytes allocated for the tree: each tag's Value, plus names, strings and elements
+  size_t maxArrayLength = SIZE_MAX;  // Elements of a single array or list
+  size_t maxDepth = SIZE_MAX;        // Lists and compounds nested inside each other, below the root tags
+  size_t maxTags = SIZE_MAX;         // Tags, counting every list element
+
+  /**
+   * @return Returns limits fit for packets from untrusted clients, in line with the 2 MiB budget and depth of 512 that
+   * Minecraft's own network decoder enforces.
+   */
+  static ReaderLimits untrusted() {
+    ReaderLimits limits;
+    limits.maxBytes = 2 * 1024 * 1024;
+    limits.maxArrayLength = 1 << 20;
+    limits.maxDepth = 512;
+    limits.maxTags = 1 << 20;
+    return limits;
+  }
+
+  [[nodiscard]] bool isUnlimited() const {
+    return maxBytes == SIZE_MAX && maxArrayLength == SIZE_MAX && maxDepth == SIZE_MAX && maxTags == SIZE_MAX;
+  }
+};
+
+struct ReaderOptions {
+  std::pmr::memory_resource* resource = std::pmr::get_default_resource();
+
+  /**
+   * Interns compound keys, e.g. &KeyTable::global() or a table shared by the documents of one world. The table's keys
+   * must outlive the parsed trees, unless they are immortal.
+   */
+  KeyTable* keyTable = nullptr;
+
+  /**
+   * Only materializes the tags on these paths, skipping over the rest of the document. Paths start at the document's
+   * root tags (e.g. "Level.xPos"), or below the blank named root tag when config::omitRootTag() is set.
+   */
+  const PathSet* paths = nullptr;
+
+  /**
+   * Decodes the elements of large lists and the entries of large compounds in parallel on pool, once a list or compound
+   * spans at least parallelThreshold bytes. Smaller documents keep the serial path. Only applies to uncompressed
+   * in-memory documents. resource and keyTable are then used from several threads and must be thread safe, as the
+   * default resource and KeyTable::global() are.
+   */
+  ThreadPool* pool = nullptr;
+  size_t parallelThreshold = 1 << 20;
+
+  /**
+   * Variant of the format to decode. Documents without a named root are returned under an empty name, like a blank
+   * named root tag.
+   */
+  Format format = Format::JAVA;
+
+  /**
+   * Limits enforced while decoding. Documents decoded under limits are decoded serially, regardless of pool.
+   */
+  ReaderLimits limits;
+};
+
+class MappedFile;
+
+/**
+ * Read-only view over a memory mapped document, which stays mapped as long as the FileView exists.
+ */
+class FileView {
+ public:
+  explicit FileView(const std::string& path);
+  ~FileView();
+
+  FileView(FileView&& other) noexcept;
+  FileView& operator=(FileView&& other) noexcept;
+
+  /**
+   * @return Returns the view over the document, following config::omitRootTag() like Reader::view.
+   */
+  [[nodiscard]] const CompoundView& getRoot() const { return m_Root; }
+
+  /**
+   * @return Returns the mapped bytes of the file.
+   */
+  [[nodiscard]] const char* data() const;
+  [[nodiscard]] size_t size() const;
+ private:
+  std::unique_ptr<MappedFile> m_File;
+  CompoundView m_Root;
+};
+
 class Reader {
  public:
-  static Compound parse(const void* data, size_t length);
+  /**
+   * Decodes a document. Every container of the resulting tree allocates from resource. Gzip and zlib compressed
+   * documents are detected from their header and inflated incrementally while decoding.
+   */
+  static Compound parse(const void* data, size_t length, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+  static Compound parse(const void* data, size_t length, const ReaderOptions& options);
+
+  /**
+   * Decodes a document from a stream. A compressed document is read to the end of its gzip or zlib member, input read
+   * past it is handed back to seekable streams, so that they are left positioned right after the document.
+   */
+  static Compound read(std::istream& in, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+  static Compound read(std::istream& in, const ReaderOptions& options);
+
+  /**
+   * Decodes a file straight from a private, read-only memory mapping instead of copying it into memory first.
+   * Compressed files are inflated from the mapping.
+   */
+  static Compound parseFile(const std::string& path, const ReaderOptions& options = {});
+
+  /**
+   * Streams the document's tags into visitor without building a tree. The root tag is reported as is, regardless of
+   * config::omitRootTag().
+   */
+  static void visit(const void* data, size_t length, Visitor& visitor);
+  static void visit(std::istream& in, Visitor& visitor);
+
+  /**
+   * Creates a read-only view over an encoded document without decoding it. The buffer must outlive the view and hold
+   * the uncompressed document.
+   */
+  static CompoundView view(const void* data, size_t length);
 
-  static Compound read(std::istream& in);
+  /**
+   * Maps an uncompressed file and creates a view over it, see FileView.
+   */
+  static FileView viewFile(const std::string& path);
 };
 
 } // namespace nbt
@@ -0,0 +1,105 @@
+#ifndef NBT_INCLUDE_NBT_NBT_REGION_HPP_
+#define NBT_INCLUDE_NBT_NBT_REGION_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "nbt_reader.hpp"
+#include "nbt_thread_pool.hpp"
+#include "nbt_type.hpp"
+#include "nbt_writer.hpp"
+
+namespace nbt {
+
+class MappedFile;
+
+/**
+ * Memory mapped Anvil region file (.mca): a 4 KiB table of chunk locations, a 4 KiB table of timestamps, then sector
+ * aligned chunks, each a big-endian length, a compression id and the compressed document. Chunk coordinates are taken
+ * modulo 32, so both region local and world chunk coordinates can be passed.
+ */
+class RegionFile {
+ public:
+  static constexpr size_t SECTOR_SIZE = 4096;
+  static constexpr size_t CHUNKS = 1024;
+
+  struct ChunkInfo {
+    uint32_t sector;       // Offset of the chunk in sectors, 0 if the chunk is absent
+    uint8_t sectorCount;
+    uint32_t timestamp;    // Last modification, in seconds since the epoch
+  };
+
+  explicit RegionFile(const std::string& path);
+  ~RegionFile();
+
+  RegionFile(RegionFile&& other) noexcept;
+  RegionFile& operator=(RegionFile&& other) noexcept;
+
+  [[nodiscard]] bool hasChunk(int32_t x, int32_t z) const;
+  [[nodiscard]] ChunkInfo getChunkInfo(int32_t x, int32_t z) const;
+
+  /**
+   * @return Returns the region local coordinates of every present chunk.
+   */
+  [[nodiscard]] std::vector<std::pair<int32_t, int32_t>> getChunks() const;
+
+  /**
+   * @return Returns the stored bytes of a chunk without copying them, compressed as reported through compression.
+   * Empty for absent chunks.
+   */
+  [[nodiscard]] std::string_view getChunkData(int32_t x, int32_t z, Compression& compression) const;
+
+  /**
+   * @return Returns the uncompressed document of a chunk, for use with Reader::view or OffsetIndex.
+   */
+  [[nodiscard]] std::vector<char> inflateChunk(int32_t x, int32_t z) const;
+
+  /**
+   * Decodes a chunk. Absent chunks decode to an empty compound.
+   */
+  [[nodiscard]] Compound readChunk(int32_t x, int32_t z, const ReaderOptions& options = {}) const;
+
+  /**
+   * Decodes chunks in parallel on pool, in the order given. options.resource and options.keyTable are shared by all
+   * threads and must be thread safe, as the default resource and KeyTable::global() are.
+   */
+  [[nodiscard]] std::vector<Compound> readChunks(const std::vector<std::pair<int32_t, int32_t>>& chunks, const ReaderOptions& options = {}, ThreadPool& pool = ThreadPool::global()) const;
+ private:
+  std::unique_ptr<MappedFile> m_File;
+};
+
+/**
+ * Writes batches of chunks into an Anvil region file, keeping the chunks it is not given.
+ */
+class RegionWriter {
+ public:
+  struct Chunk {
+    int32_t x;
+    int32_t z;
+    const Compound* compound;  // nullptr removes the chunk
+  };
+
+  /**
+   * Writes to path, which is created as an empty region on the first write if it does not exist.
+   */
+  explicit RegionWriter(std::string path, Compression compression = Compression::ZLIB);
+
+  /**
+   * Encodes and compresses chunks in parallel on pool, then stores them in free or appended sectors using one write per
+   * contiguous run of sectors, followed by a single header update. Sectors released by a call are only reused by later
+   * calls, so that an interrupted write leaves the previous version of every chunk intact.
+   */
+  void write(const std::vector<Chunk>& chunks, ThreadPool& pool = ThreadPool::global());
+ private:
+  std::string m_Path;
+  Compression m_Compression;
+};
+
+} // namespace nbt
+
+#endif //NBT_INCLUDE_NBT_NBT_REGION_HPP_
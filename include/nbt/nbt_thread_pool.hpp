@@ -0,0 +1,56 @@
+#ifndef NBT_INCLUDE_NBT_NBT_THREAD_POOL_HPP_
+#define NBT_INCLUDE_NBT_NBT_THREAD_POOL_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nbt {
+
+/**
+ * Fixed set of worker threads that run indexed tasks for the parallel parts of the library. The thread calling run()
+ * works on its own tasks too, so run() may be called from inside a task without deadlocking.
+ */
+class ThreadPool {
+ public:
+  explicit ThreadPool(size_t workers);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * Calls task(i) for every i in [0, count) across the workers and the calling thread, returning once all calls have
+   * finished. The first exception thrown by a task is rethrown here.
+   */
+  void run(size_t count, const std::function<void(size_t)>& task);
+
+  /**
+   * @return Returns the number of threads that execute tasks, including the caller of run().
+   */
+  [[nodiscard]] size_t getConcurrency() const;
+
+  /**
+   * @return Returns a process wide pool with one thread per hardware thread, created on first use.
+   */
+  static ThreadPool& global();
+ private:
+  struct Job;
+
+  void work();
+  void execute(Job& job, size_t index);
+
+  std::vector<std::thread> m_Threads;
+  std::mutex m_Mutex;
+  std::condition_variable m_Wake;
+  std::deque<Job*> m_Jobs;
+  bool m_Stopping;
+};
+
+} // namespace nbt
+
+#endif //NBT_INCLUDE_NBT_NBT_THREAD_POOL_HPP_
@@ -1,17 +1,27 @@
 #ifndef NBT_INCLUDE_NBT_NBT_TYPE_HPP_
 #define NBT_INCLUDE_NBT_NBT_TYPE_HPP_
 
+#include <atomic>
 #include <cstdint>
+#include <memory_resource>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <utility>
+#include <variant>
 #include <vector>
 
+#include "nbt_key.hpp"
+
 namespace nbt {
 
-using ByteArray = std::vector<int8_t>;
-using IntArray = std::vector<int16_t>;
-using LongArray = std::vector<int32_t>;
-using String = std::string;
+/**
+ * Containers allocate from a std::pmr::memory_resource, the default resource unless one is passed on construction
+ * (or to Reader::parse), so that a whole document can be placed in an arena such as std::pmr::monotonic_buffer_resource.
+ */
+using ByteArray = std::pmr::vector<int8_t>;
+using IntArray = std::pmr::vector<int32_t>;
+using LongArray = std::pmr::vector<int64_t>;
+using String = std::pmr::string;
 
 enum class Type : int8_t {
   BYTE = 1,
@@ -28,22 +38,66 @@ enum class Type : int8_t {
   LONG_ARRAY = 12
 };
 
+/**
+ * Variants of the binary format.
+ */
+enum class Format {
+  JAVA,             // Big-endian with a named root, as in Java Edition files
+  JAVA_NETWORK,     // Java Edition network protocol since 1.20.2, whose root compound has no name
+  BEDROCK,          // Little-endian, as in Bedrock Edition files, without the level.dat header
+  BEDROCK_NETWORK   // Bedrock Edition network protocol, little-endian with varint ints, longs and lengths
+};
+
 class Value;
 
+/**
+ * Reference counted allocation holding the payload of a Value that is not a primitive, see Value::share().
+ */
+template<typename T>
+struct Box;
+
+/**
+ * Entries are stored contiguously in insertion order, which is also the order they are written in. Small compounds are
+ * searched linearly, larger ones additionally maintain an open addressing hash index over the entries. Keys carry their
+ * hash, and interned keys (see KeyTable) match by pointer.
+ */
 class Compound {
  public:
-  using Iterator = std::unordered_map<std::string, Value>::iterator;
-  using ConstIterator = std::unordered_map<std::string, Value>::const_iterator;
+  using Entry = std::pair<Key, Value>;
+  using Iterator = std::pmr::vector<Entry>::iterator;
+  using ConstIterator = std::pmr::vector<Entry>::const_iterator;
 
-  bool operator==(const Compound& rhs) const;
-  Value& operator[](const char*);
+  Compound() = default;
+  explicit Compound(std::pmr::memory_resource* resource);
 
-  void insert(std::string key, Value value);
-
-  const Value* get(const char*) const;
-
-  bool hasKey(const char*) const;
-  bool remove(const char*);
+  bool operator==(const Compound& rhs) const;
+  Value& operator[](std::string_view key);
+  Value& operator[](const Key& key);
+
+  void insert(std::string_view key, Value value);
+  void insert(Key key, Value value);
+
+  [[nodiscard]] Value* get(std::string_view key);
+  [[nodiscard]] const Value* get(std::string_view key) const;
+  [[nodiscard]] Value* get(const Key& key);
+  [[nodiscard]] const Value* get(const Key& key) const;
+
+  [[nodiscard]] bool hasKey(std::string_view key) const;
+  [[nodiscard]] bool hasKey(const Key& key) const;
+  /**
+   * Removes the entry for key, keeping the order of the others. Removing the last entry takes constant time, removing
+   * an earlier one shifts the entries after it.
+   * @return Returns whether an entry was removed.
+   */
+  bool remove(std::string_view key);
+  void clear();
+
+  void reserve(size_t size);
+
+  /**
+   * @return Returns a copy that shares the entries' payloads copy-on-write, see Value::share().
+   */
+  [[nodiscard]] Compound share() const;
 
   Iterator begin();
   [[nodiscard]] ConstIterator begin() const;
@@ -52,17 +106,44 @@ class Compound {
   [[nodiscard]] ConstIterator end() const;
 
   [[nodiscard]] size_t size() const;
+  [[nodiscard]] std::pmr::memory_resource* getResource() const;
  private:
-  std::unordered_map<std::string, Value> m_Values;
+  struct Slot {
+    uint32_t hash;
+    uint32_t index;  // Entry index + 1, 0 marks an empty slot
+  };
+
+  [[nodiscard]] size_t find(std::string_view key, uint32_t hash) const;
+  [[nodiscard]] size_t find(const Key& key) const;
+  Value& append(Key key);
+  void indexEntry(size_t index, uint32_t hash);
+  void unindexEntry(size_t index, uint32_t hash);
+  void rebuildIndex();
+
+  std::pmr::vector<Entry> m_Values;
+  std::pmr::vector<Slot> m_Index;
 };
 
+/**
+ * Lists of BYTE, SHORT, INT, LONG, FLOAT or DOUBLE elements are stored unboxed, as one contiguous vector of the element
+ * type, which the typed accessors (getLongs() etc.) expose. Element access through Value works for every list: const
+ * access boxes the elements into a cached copy on first use, while mutable access (non-const operator[] and begin()/end())
+ * converts the list to Value storage until a typed accessor is used again.
+ */
 class List {
  public:
-  using Iterator = std::vector<Value>::iterator;
-  using ConstIterator = std::vector<Value>::const_iterator;
+  using Iterator = std::pmr::vector<Value>::iterator;
+  using ConstIterator = std::pmr::vector<Value>::const_iterator;
 
-  List() {}
+  List() : List(static_cast<Type>(0)) {}
   List(Type);
+  List(Type, std::pmr::memory_resource* resource);
+  List(const List& rhs);
+  List(List&& rhs) noexcept;
+  ~List();
+
+  List& operator=(const List& rhs);
+  List& operator=(List&& rhs) noexcept;
 
   bool operator==(const List& rhs) const;
   Value& operator[](size_t index);
@@ -70,11 +151,22 @@ class List {
 
   void pushBack(Value value);
 
+  /**
+   * Replaces count elements, from offset on, with the elements of a list of the same element type.
+   */
+  void splice(size_t offset, size_t count, const List& elements);
+
   void setType(Type type);
 
+  /**
+   * @return Returns a copy that shares the elements' payloads copy-on-write, see Value::share(). Unboxed elements are
+   * copied.
+   */
+  [[nodiscard]] List share() const;
+
   template <typename T>
   void emplaceBack(T&& value) {
-    m_Values.emplace_back(std::forward<T>(value));
+    pushBack(Value(std::forward<T>(value)));
   }
 
   Iterator begin();
@@ -83,11 +175,53 @@ class List {
   Iterator end();
   [[nodiscard]] ConstIterator end() const;
 
+  /**
+   * Typed element access for lists of the matching element type. The const overloads require unboxed storage, see
+   * hasTypedStorage().
+   */
+  [[nodiscard]] ByteArray& getBytes();
+  [[nodiscard]] const ByteArray& getBytes() const;
+
+  [[nodiscard]] std::pmr::vector<int16_t>& getShorts();
+  [[nodiscard]] const std::pmr::vector<int16_t>& getShorts() const;
+
+  [[nodiscard]] IntArray& getInts();
+  [[nodiscard]] const IntArray& getInts() const;
+
+  [[nodiscard]] LongArray& getLongs();
+  [[nodiscard]] const LongArray& getLongs() const;
+
+  [[nodiscard]] std::pmr::vector<float>& getFloats();
+  [[nodiscard]] const std::pmr::vector<float>& getFloats() const;
+
+  [[nodiscard]] std::pmr::vector<double>& getDoubles();
+  [[nodiscard]] const std::pmr::vector<double>& getDoubles() const;
+
+  /**
+   * @return Returns whether the elements are currently stored unboxed.
+   */
+  [[nodiscard]] bool hasTypedStorage() const;
+
   [[nodiscard]] Type getType() const;
   [[nodiscard]] size_t size() const;
+  [[nodiscard]] std::pmr::memory_resource* getResource() const;
  private:
+  // Index 0 holds boxed elements, the others match the primitive Type values.
+  using Storage = std::variant<std::pmr::vector<Value>, ByteArray, std::pmr::vector<int16_t>, IntArray, LongArray, std::pmr::vector<float>, std::pmr::vector<double>>;
+
+  template<typename T>
+  std::pmr::vector<T>& unboxed();
+  template<typename T>
+  const std::pmr::vector<T>& unboxed() const;
+
+  void box();
+  [[nodiscard]] const std::pmr::vector<Value>& boxed() const;
+  [[nodiscard]] Value element(size_t index) const;
+  void clearCache();
+
   Type m_Type;
-  std::vector<Value> m_Values;
+  Storage m_Storage;
+  mutable std::atomic<std::pmr::vector<Value>*> m_Cache;  // Boxed copy of unboxed elements for const access
 };
 
 class Value {
@@ -102,10 +236,15 @@ class Value {
   Value(int64_t);
   Value(float);
   Value(double);
-  Value(std::vector<int8_t>);
-  Value(std::vector<int32_t>);
-  Value(std::vector<int64_t>);
-  Value(std::string string);
+  Value(ByteArray);
+  Value(IntArray);
+  Value(LongArray);
+  Value(const std::vector<int8_t>&);
+  Value(const std::vector<int32_t>&);
+  Value(const std::vector<int64_t>&);
+  Value(String string);
+  Value(std::string_view string);
+  Value(const char* string);
   Value(Compound compound);
   Value(List list);
   ~Value();
@@ -121,16 +260,36 @@ class Value {
   Value& operator=(float);
   Value& operator=(double);
 
-  Value& operator=(std::vector<int8_t>);
-  Value& operator=(std::vector<int32_t>);
-  Value& operator=(std::vector<int64_t>);
+  Value& operator=(ByteArray);
+  Value& operator=(IntArray);
+  Value& operator=(LongArray);
 
-  Value& operator=(std::string string);
+  Value& operator=(const std::vector<int8_t>&);
+  Value& operator=(const std::vector<int32_t>&);
+  Value& operator=(const std::vector<int64_t>&);
+
+  Value& operator=(String string);
+  Value& operator=(std::string_view string);
+  Value& operator=(const char* string);
   Value& operator=(Compound compound);
   Value& operator=(List list);
 
+  /**
+   * Compares payloads deeply, except that values sharing a payload, see share(), are equal without comparing it. A
+   * compound or list holding a NaN is thus equal to its snapshots, but not to a deep copy.
+   */
   bool operator==(const Value& rhs) const;
 
+  /**
+   * Copies the value copy-on-write: rather than deep-copying compounds, lists, strings and arrays, the copy shares them
+   * with this value, in O(1). Whichever copy is modified first clones a shared payload on mutable access (getCompound(),
+   * getList() etc.), one level at a time, so modifying a tag only copies the path leading to it. Plain copies remain
+   * deep copies. References returned by mutable accessors before sharing must not be used to modify either copy: they
+   * point into the shared payload, so writes through them show in both.
+   * Reference counts are atomic: copies may be used on different threads if their memory resource is thread safe.
+   */
+  [[nodiscard]] Value share() const;
+
   template <typename T>
   void set(T value) {
     operator=(std::move(value));
@@ -146,17 +305,17 @@ class Value {
   [[nodiscard]] float getFloat() const;
   [[nodiscard]] double getDouble() const;
 
-  [[nodiscard]] std::vector<int8_t>& getByteArray();
-  [[nodiscard]] const std::vector<int8_t>& getByteArray() const;
+  [[nodiscard]] ByteArray& getByteArray();
+  [[nodiscard]] const ByteArray& getByteArray() const;
 
-  [[nodiscard]] std::vector<int32_t>& getIntArray();
-  [[nodiscard]] const std::vector<int32_t>& getIntArray() const;
+  [[nodiscard]] IntArray& getIntArray();
+  [[nodiscard]] const IntArray& getIntArray() const;
 
-  [[nodiscard]] std::vector<int64_t>& getLongArray();
-  [[nodiscard]] const std::vector<int64_t>& getLongArray() const;
+  [[nodiscard]] LongArray& getLongArray();
+  [[nodiscard]] const LongArray& getLongArray() const;
 
-  [[nodiscard]] std::string& getString();
-  [[nodiscard]] const std::string& getString() const;
+  [[nodiscard]] String& getString();
+  [[nodiscard]] const String& getString() const;
 
   [[nodiscard]] Compound& getCompound();
   [[nodiscard]] const Compound& getCompound() const;
@@ -168,6 +327,8 @@ class Value {
 
   Type m_Type;
 
+  // Primitives are stored inline, other types are boxed in an allocation from their own memory resource, which keeps
+  // a Value at 16 bytes and makes moving one a copy of the pointer.
   union {
     int8_t m_Byte;
     int16_t m_Short;
@@ -177,16 +338,18 @@ class Value {
     float m_Float;
     double m_Double;
 
-    std::vector<int8_t> m_ByteArray;
-    std::vector<int32_t> m_IntArray;
-    std::vector<int64_t> m_LongArray;
+    Box<ByteArray>* m_ByteArray;
+    Box<IntArray>* m_IntArray;
+    Box<LongArray>* m_LongArray;
 
-    std::string m_String;
-    Compound m_Compound;
-    List m_List;
+    Box<String>* m_String;
+    Box<Compound>* m_Compound;
+    Box<List>* m_List;
   };
 };
 
+static_assert(sizeof(Value) <= 16);
+
 } // namespace nbt
 
 #endif //NBT_INCLUDE_NBT_NBT_TYPE_HPP_
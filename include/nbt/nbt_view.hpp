@@ -0,0 +1,257 @@
+#ifndef NBT_INCLUDE_NBT_NBT_VIEW_HPP_
+#define NBT_INCLUDE_NBT_NBT_VIEW_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "nbt_type.hpp"
+
+namespace nbt {
+
+/**
+ * Read-only view over a big-endian encoded array payload. Elements are decoded on access.
+ */
+template<typename T>
+class ArrayView {
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = T;
+
+    Iterator() : m_Data(nullptr) {}
+    explicit Iterator(const char* data) : m_Data(data) {}
+
+    T operator*() const { return decode(m_Data); }
+    T operator[](difference_type index) const { return decode(m_Data + index * sizeof(T)); }
+
+    Iterator& operator++() { m_Data += sizeof(T); return *this; }
+    Iterator operator++(int) { Iterator it = *this; m_Data += sizeof(T); return it; }
+    Iterator& operator--() { m_Data -= sizeof(T); return *this; }
+    Iterator operator--(int) { Iterator it = *this; m_Data -= sizeof(T); return it; }
+    Iterator& operator+=(difference_type n) { m_Data += n * static_cast<difference_type>(sizeof(T)); return *this; }
+    Iterator& operator-=(difference_type n) { m_Data -= n * static_cast<difference_type>(sizeof(T)); return *this; }
+    Iterator operator+(difference_type n) const { return Iterator(m_Data + n * static_cast<difference_type>(sizeof(T))); }
+    Iterator operator-(difference_type n) const { return Iterator(m_Data - n * static_cast<difference_type>(sizeof(T))); }
+    difference_type operator-(const Iterator& rhs) const { return (m_Data - rhs.m_Data) / static_cast<difference_type>(sizeof(T)); }
+
+    bool operator==(const Iterator& rhs) const { return m_Data == rhs.m_Data; }
+    bool operator!=(const Iterator& rhs) const { return m_Data != rhs.m_Data; }
+    bool operator<(const Iterator& rhs) const { return m_Data < rhs.m_Data; }
+   private:
+    const char* m_Data;
+  };
+
+  ArrayView() : m_Data(nullptr), m_Size(0) {}
+  ArrayView(const char* data, size_t size) : m_Data(data), m_Size(size) {}
+
+  T operator[](size_t index) const { return decode(m_Data + index * sizeof(T)); }
+
+  [[nodiscard]] Iterator begin() const { return Iterator(m_Data); }
+  [[nodiscard]] Iterator end() const { return Iterator(m_Data + m_Size * sizeof(T)); }
+
+  [[nodiscard]] std::pmr::vector<T> toVector(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const {
+    return std::pmr::vector<T>(begin(), end(), resource);
+  }
+
+  /**
+   * @return Returns the raw big-endian payload, size() * sizeof(T) bytes long.
+   */
+  [[nodiscard]] const char* data() const { return m_Data; }
+  [[nodiscard]] size_t size() const { return m_Size; }
+  [[nodiscard]] bool empty() const { return m_Size == 0; }
+ private:
+  static T decode(const char* data) {
+    using Bits = std::conditional_t<sizeof(T) == 1, uint8_t, std::conditional_t<sizeof(T) == 2, uint16_t, std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+    Bits bits = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+      bits = static_cast<Bits>((bits << 8) | static_cast<uint8_t>(data[i]));
+    }
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+  }
+
+  const char* m_Data;
+  size_t m_Size;
+};
+
+class CompoundView;
+class ListView;
+
+/**
+ * Read-only view over a single encoded tag payload. Holds pointers into the source buffer, which must outlive the view.
+ */
+class View {
+ public:
+  View() : m_Type(static_cast<Type>(0)), m_Data(nullptr), m_End(nullptr) {}
+  View(Type type, const char* data, const char* end) : m_Type(type), m_Data(data), m_End(end) {}
+
+  /**
+   * @return Returns false for the empty view returned by failed lookups.
+   */
+  explicit operator bool() const { return m_Type != static_cast<Type>(0); }
+
+  [[nodiscard]] Type getType() const { return m_Type; }
+
+  [[nodiscard]] int8_t getByte() const;
+  [[nodiscard]] int16_t getShort() const;
+  [[nodiscard]] int32_t getInt() const;
+  [[nodiscard]] int64_t getLong() const;
+
+  [[nodiscard]] float getFloat() const;
+  [[nodiscard]] double getDouble() const;
+
+  [[nodiscard]] ArrayView<int8_t> getByteArray() const;
+  [[nodiscard]] ArrayView<int32_t> getIntArray() const;
+  [[nodiscard]] ArrayView<int64_t> getLongArray() const;
+
+  /**
+   * @return Returns whether the string payload is pure ASCII, in which case getStringView() can be used.
+   */
+  [[nodiscard]] bool isAscii() const;
+
+  /**
+   * @return Returns the string without copying. Throws if the string is not pure ASCII.
+   */
+  [[nodiscard]] std::string_view getStringView() const;
+
+  /**
+   * @return Returns the decoded string.
+   */
+  [[nodiscard]] String getString(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+  [[nodiscard]] CompoundView getCompound() const;
+  [[nodiscard]] ListView getList() const;
+
+  /**
+   * @return Returns the encoded payload bytes of the tag.
+   */
+  [[nodiscard]] const char* data() const { return m_Data; }
+  [[nodiscard]] size_t size() const { return static_cast<size_t>(m_End - m_Data); }
+ private:
+  Type m_Type;
+  const char* m_Data;
+  const char* m_End;
+};
+
+/**
+ * Read-only view over an encoded compound. Lookups walk the encoded entries in place.
+ */
+class CompoundView {
+ public:
+  struct Entry {
+    std::string_view name;  // Raw modified UTF-8 bytes, identical to the key for ASCII keys.
+    View value;
+  };
+
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Entry;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Entry*;
+    using reference = const Entry&;
+
+    Iterator() : m_Next(nullptr), m_End(nullptr) {}
+    Iterator(const char* position, const char* end);
+
+    const Entry& operator*() const { return m_Entry; }
+    const Entry* operator->() const { return &m_Entry; }
+
+    Iterator& operator++();
+    Iterator operator++(int) { Iterator it = *this; operator++(); return it; }
+
+    bool operator==(const Iterator& rhs) const { return m_Next == rhs.m_Next; }
+    bool operator!=(const Iterator& rhs) const { return m_Next != rhs.m_Next; }
+   private:
+    Entry m_Entry;
+    const char* m_Next;
+    const char* m_End;
+  };
+
+  CompoundView() : m_Data(nullptr), m_End(nullptr) {}
+  CompoundView(const char* data, const char* end) : m_Data(data), m_End(end) {}
+
+  /**
+   * @return Returns the value stored under key, or an empty view if there is none.
+   */
+  [[nodiscard]] View get(std::string_view key) const;
+  [[nodiscard]] bool hasKey(std::string_view key) const;
+
+  [[nodiscard]] Iterator begin() const;
+  [[nodiscard]] Iterator end() const;
+
+  /**
+   * @return Returns the number of entries. Walks the whole compound.
+   */
+  [[nodiscard]] size_t size() const;
+ private:
+  const char* m_Data;
+  const char* m_End;
+};
+
+/**
+ * Read-only view over an encoded list.
+ */
+class ListView {
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = View;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const View*;
+    using reference = const View&;
+
+    Iterator() : m_Next(nullptr), m_End(nullptr), m_Remaining(0) {}
+    Iterator(Type type, const char* position, const char* end, size_t remaining);
+
+    const View& operator*() const { return m_Value; }
+    const View* operator->() const { return &m_Value; }
+
+    Iterator& operator++();
+    Iterator operator++(int) { Iterator it = *this; operator++(); return it; }
+
+    bool operator==(const Iterator& rhs) const { return m_Remaining == rhs.m_Remaining; }
+    bool operator!=(const Iterator& rhs) const { return m_Remaining != rhs.m_Remaining; }
+   private:
+    View m_Value;
+    const char* m_Next;
+    const char* m_End;
+    size_t m_Remaining;
+  };
+
+  ListView() : m_Type(static_cast<Type>(0)), m_Size(0), m_Data(nullptr), m_End(nullptr) {}
+  ListView(Type type, size_t size, const char* data, const char* end) : m_Type(type), m_Size(size), m_Data(data), m_End(end) {}
+
+  /**
+   * @return Returns the element at index. Constant time for fixed size element types, linear otherwise.
+   */
+  View operator[](size_t index) const;
+
+  [[nodiscard]] Iterator begin() const;
+  [[nodiscard]] Iterator end() const;
+
+  [[nodiscard]] Type getType() const { return m_Type; }
+  [[nodiscard]] size_t size() const { return m_Size; }
+ private:
+  Type m_Type;
+  size_t m_Size;
+  const char* m_Data;
+  const char* m_End;
+};
+
+} // namespace nbt
+
+#endif //NBT_INCLUDE_NBT_NBT_VIEW_HPP_
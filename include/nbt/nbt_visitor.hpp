@@ -0,0 +1,49 @@
+#ifndef NBT_INCLUDE_NBT_NBT_VISITOR_HPP_
+#define NBT_INCLUDE_NBT_NBT_VISITOR_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "nbt_type.hpp"
+#include "nbt_view.hpp"
+
+namespace nbt {
+
+/**
+ * Receives the tags of a document in encoding order from Reader::visit, without a tree being built. Names, strings and
+ * arrays are only valid for the duration of the callback. List elements are reported with an empty name.
+ */
+class Visitor {
+ public:
+  virtual ~Visitor() = default;
+
+  virtual void onByte(std::string_view /*name*/, int8_t /*value*/) {}
+  virtual void onShort(std::string_view /*name*/, int16_t /*value*/) {}
+  virtual void onInt(std::string_view /*name*/, int32_t /*value*/) {}
+  virtual void onLong(std::string_view /*name*/, int64_t /*value*/) {}
+  virtual void onFloat(std::string_view /*name*/, float /*value*/) {}
+  virtual void onDouble(std::string_view /*name*/, double /*value*/) {}
+
+  virtual void onByteArray(std::string_view /*name*/, ArrayView<int8_t> /*values*/) {}
+  virtual void onIntArray(std::string_view /*name*/, ArrayView<int32_t> /*values*/) {}
+  virtual void onLongArray(std::string_view /*name*/, ArrayView<int64_t> /*values*/) {}
+
+  virtual void onString(std::string_view /*name*/, std::string_view /*value*/) {}
+
+  /**
+   * @return Returns false to skip the list's elements, onListEnd() is then not called.
+   */
+  virtual bool onListBegin(std::string_view /*name*/, Type /*elementType*/, size_t /*length*/) { return true; }
+  virtual void onListEnd() {}
+
+  /**
+   * @return Returns false to skip the compound's entries, onCompoundEnd() is then not called.
+   */
+  virtual bool onCompoundBegin(std::string_view /*name*/) { return true; }
+  virtual void onCompoundEnd() {}
+};
+
+} // namespace nbt
+
+#endif //NBT_INCLUDE_NBT_NBT_VISITOR_HPP_
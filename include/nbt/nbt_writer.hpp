@@ -1,17 +1,60 @@
 #ifndef NBT_INCLUDE_NBT_NBT_WRITER_HPP_
 #define NBT_INCLUDE_NBT_NBT_WRITER_HPP_
 
-#include <functional>
 #include <ostream>
+#include <vector>
 
 #include "nbt_type.hpp"
 
 namespace nbt {
 
+/**
+ * Container formats of documents on disk. Reader detects them from the header bytes.
+ */
+enum class Compression {
+  NONE,
+  GZIP,
+  ZLIB
+};
+
 class Writer {
  public:
   static void write(std::ostream& out, const Compound& compound, const std::string_view& name = "");
-  static std::vector<char> writeToBuffer(const Compound& compound, const std::string_view& key = "");
+
+  /**
+   * Writes the document compressed, deflating the encoded bytes straight into out one window at a time.
+   */
+  static void write(std::ostream& out, const Compound& compound, Compression compression, const std::string_view& name = "");
+  static void write(std::ostream& out, const Compound& compound, Format format, const std::string_view& name = "");
+
+  /**
+   * Encodes the document into a single allocation of exactly getEncodedSize() bytes.
+   */
+  static std::vector<char> writeToBuffer(const Compound& compound, const std::string_view& name = "");
+
+  /**
+   * Encodes the document in another variant of the format. name is ignored by formats without a named root, and
+   * config::writeRootTag() only applies to formats with one.
+   */
+  static std::vector<char> writeToBuffer(const Compound& compound, Format format, const std::string_view& name = "");
+  static void writeToBuffer(const Compound& compound, std::vector<char>& buffer, Format format, const std::string_view& name = "");
+
+  /**
+   * Encodes the document into buffer, replacing its contents but reusing its capacity.
+   */
+  static void writeToBuffer(const Compound& compound, std::vector<char>& buffer, const std::string_view& name = "");
+
+  /**
+   * Encodes the document into a caller-supplied buffer of capacity bytes, throwing if it does not fit.
+   * @return Returns the number of bytes written.
+   */
+  static size_t writeToBuffer(const Compound& compound, void* buffer, size_t capacity, const std::string_view& name = "");
+
+  /**
+   * @return Returns the exact number of bytes the document encodes to.
+   */
+  static size_t getEncodedSize(const Compound& compound, const std::string_view& name = "");
+  static size_t getEncodedSize(const Compound& compound, Format format, const std::string_view& name = "");
 };
 
 } // namespace nbt
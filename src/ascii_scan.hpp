@@ -0,0 +1,63 @@
+#ifndef NBT_SRC_ASCII_SCAN_HPP_
+#define NBT_SRC_ASCII_SCAN_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define NBT_ASCII_SSE2
+  #include <emmintrin.h>
+  #ifdef _MSC_VER
+    #include <intrin.h>
+  #endif
+#endif
+
+namespace nbt::utf {
+
+#ifdef NBT_ASCII_SSE2
+inline size_t firstSetBit(uint32_t mask) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return static_cast<size_t>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+/**
+ * Scans 16 bytes at a time (8 without SSE2) for the first byte that is not plain ASCII.
+ * @tparam ALLOW_NUL Whether NUL bytes count as ASCII. Modified UTF-8 encodes them in two bytes.
+ * @return Returns the length of the ASCII prefix of data.
+ */
+template<bool ALLOW_NUL>
+inline size_t asciiPrefix(const char* data, size_t length) {
+  size_t i = 0;
+#ifdef NBT_ASCII_SSE2
+  for (; i + 16 <= length; i += 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    auto mask = static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+    if constexpr (!ALLOW_NUL) mask |= static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_setzero_si128())));
+    if (mask != 0) return i + firstSetBit(mask);
+  }
+#else
+  for (; i + 8 <= length; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    uint64_t stop = word & 0x8080808080808080ULL;
+    if constexpr (!ALLOW_NUL) stop |= (word - 0x0101010101010101ULL) & ~word & 0x8080808080808080ULL;  // Zero bytes
+    if (stop != 0) break;
+  }
+#endif
+  for (; i < length; i++) {
+    auto c = static_cast<uint8_t>(data[i]);
+    if (c > 0x7F || (!ALLOW_NUL && c == 0)) break;
+  }
+  return i;
+}
+
+} // namespace nbt::utf
+
+#endif //NBT_SRC_ASCII_SCAN_HPP_
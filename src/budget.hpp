@@ -0,0 +1,61 @@
+#ifndef NBT_SRC_BUDGET_HPP_
+#define NBT_SRC_BUDGET_HPP_
+
+#include <cstddef>
+#include <stdexcept>
+
+#include "nbt/nbt_reader.hpp"
+
+namespace nbt {
+
+/**
+ * Accounts for what decoding a document allocates against ReaderLimits, failing as soon as a limit is exceeded.
+ */
+class Budget {
+ public:
+  explicit Budget(const ReaderLimits& limits = {}) : m_Limits(limits), m_Bytes(0), m_Tags(0), m_Depth(0) {}
+
+  /**
+   * Accounts for tags about to be decoded, and for the bytes they will allocate.
+   */
+  void charge(size_t tags, size_t bytes) {
+    m_Tags += tags;
+    m_Bytes += bytes;
+    if (m_Tags > m_Limits.maxTags) throw std::runtime_error("nbt document has too many tags");
+    if (m_Bytes > m_Limits.maxBytes) throw std::runtime_error("nbt document exceeds its memory budget");
+  }
+
+  /**
+   * Checks the announced length of an array or list, before storage is allocated for its elements.
+   */
+  void checkLength(size_t length) const {
+    if (length > m_Limits.maxArrayLength) throw std::runtime_error("nbt array too long");
+  }
+
+  /**
+   * Enters a list or compound.
+   */
+  void enter() {
+    if (++m_Depth > m_Limits.maxDepth) throw std::runtime_error("nbt document nested too deeply");
+  }
+
+  void leave() {
+    m_Depth--;
+  }
+
+  /**
+   * @return Returns how many more levels of lists and compounds may be nested.
+   */
+  [[nodiscard]] size_t getDepthLeft() const {
+    return m_Limits.maxDepth - m_Depth;
+  }
+ private:
+  ReaderLimits m_Limits;
+  size_t m_Bytes;
+  size_t m_Tags;
+  size_t m_Depth;
+};
+
+} // namespace nbt
+
+#endif //NBT_SRC_BUDGET_HPP_
@@ -0,0 +1,180 @@
+#ifndef NBT_SRC_BUFFER_INPUT_HPP_
+#define NBT_SRC_BUFFER_INPUT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "nbt/nbt_type.hpp"
+#include "primitive.hpp"
+
+namespace nbt {
+
+/**
+ * Bounds-checked cursor over an encoded, in-memory NBT buffer.
+ */
+class BufferInput {
+ public:
+  /**
+   * Whether require() verifies lengths against the remaining input, before anything is allocated for them.
+   */
+  static constexpr bool BOUNDED = true;
+
+  BufferInput(const char* data, const char* end) : m_Position(data), m_End(end) {}
+
+  /**
+   * Advances the cursor by length bytes.
+   * @return Returns the position before advancing.
+   */
+  const char* consume(size_t length) {
+    require(length);
+    const char* position = m_Position;
+    m_Position += length;
+    return position;
+  }
+
+  void read(char* destination, size_t length) {
+    std::memcpy(destination, consume(length), length);
+  }
+
+  void skip(size_t length) {
+    consume(length);
+  }
+
+  /**
+   * Fails unless at least length more bytes are available.
+   */
+  void require(size_t length) const {
+    if (remaining() < length) throw std::runtime_error("unexpected end of nbt data");
+  }
+
+  template<typename T, typename Codec = JavaCodec>
+  T readPrimitive() {
+    return Primitive<T, Codec>::load(consume(Primitive<T, Codec>::getSize()));
+  }
+
+  Type readType() {
+    return static_cast<Type>(*consume(1));
+  }
+
+  /**
+   * @return Returns the next byte without consuming it, or EOF if the buffer is exhausted.
+   */
+  int peek() const {
+    if (m_Position == m_End) return EOF;
+    return static_cast<uint8_t>(*m_Position);
+  }
+
+  [[nodiscard]] const char* position() const { return m_Position; }
+  [[nodiscard]] const char* end() const { return m_End; }
+  [[nodiscard]] size_t remaining() const { return static_cast<size_t>(m_End - m_Position); }
+ private:
+  const char* m_Position;
+  const char* m_End;
+};
+
+/**
+ * Whether an input hands out pointers to its bytes through consume(), valid at least until its next read, so that
+ * decoding can skip copying names and strings into scratch buffers.
+ */
+template<typename Input, typename = void>
+struct HasConsume : std::false_type {};
+
+template<typename Input>
+struct HasConsume<Input, std::void_t<decltype(std::declval<Input&>().consume(size_t()))>> : std::true_type {};
+
+/**
+ * @return Returns the payload size of fixed size types, or 0 for variable length types.
+ */
+inline size_t fixedPayloadSize(Type type) {
+  switch (type) {
+    case Type::BYTE: return 1;
+    case Type::SHORT: return 2;
+    case Type::INT:
+    case Type::FLOAT: return 4;
+    case Type::LONG:
+    case Type::DOUBLE: return 8;
+    default: return 0;
+  }
+}
+
+/**
+ * @return Returns the payload size of types that have a fixed size under Codec, or 0 for variable length types.
+ */
+template<typename Codec>
+inline size_t fixedPayloadSize(Type type) {
+  if constexpr (Codec::VARINTS) {
+    if (type == Type::INT || type == Type::LONG) return 0;
+  }
+  return fixedPayloadSize(type);
+}
+
+/**
+ * Moves the input past the payload of a tag of the given type without decoding it, through at most depth levels of
+ * nested lists and compounds.
+ */
+template<typename Codec = JavaCodec, typename Input>
+inline void skipPayload(Input& in, Type type, size_t depth = SIZE_MAX) {
+  switch (type) {
+    case Type::BYTE:
+    case Type::SHORT:
+    case Type::INT:
+    case Type::FLOAT:
+    case Type::LONG:
+    case Type::DOUBLE:
+      if (fixedPayloadSize<Codec>(type) == 0) {
+        readVarint(in, 10);  // INT or LONG
+      } else {
+        in.skip(fixedPayloadSize(type));
+      }
+      break;
+    case Type::BYTE_ARRAY:
+    case Type::INT_ARRAY:
+    case Type::LONG_ARRAY: {
+      auto length = Primitive<int32_t, Codec>::readFrom(in);
+      if (length < 0) throw std::runtime_error("negative nbt array length");
+      if (type != Type::BYTE_ARRAY && Codec::VARINTS) {
+        for (int32_t i = 0; i < length; i++) skipPayload<Codec>(in, type == Type::INT_ARRAY ? Type::INT : Type::LONG);
+        break;
+      }
+      size_t elementSize = type == Type::BYTE_ARRAY ? 1 : type == Type::INT_ARRAY ? 4 : 8;
+      in.skip(static_cast<size_t>(length) * elementSize);
+      break;
+    }
+    case Type::STRING: in.skip(Primitive<uint16_t, Codec>::readFrom(in));
+      break;
+    case Type::LIST: {
+      if (depth == 0) throw std::runtime_error("nbt document nested too deeply");
+      Type elementType = in.readType();
+      auto length = Primitive<int32_t, Codec>::readFrom(in);
+      if (static_cast<Type>(0) == elementType || length <= 0) break;
+      if (size_t elementSize = fixedPayloadSize<Codec>(elementType); elementSize != 0) {
+        in.skip(static_cast<size_t>(length) * elementSize);
+        break;
+      }
+      for (int32_t i = 0; i < length; i++) {
+        skipPayload<Codec>(in, elementType, depth - 1);
+      }
+      break;
+    }
+    case Type::COMPOUND: {
+      if (depth == 0) throw std::runtime_error("nbt document nested too deeply");
+      Type elementType = in.readType();
+      while (elementType != static_cast<Type>(0)) {
+        in.skip(Primitive<uint16_t, Codec>::readFrom(in));
+        skipPayload<Codec>(in, elementType, depth - 1);
+        elementType = in.readType();
+      }
+      break;
+    }
+    default:throw std::runtime_error("invalid nbt type");
+  }
+}
+
+} // namespace nbt
+
+#endif //NBT_SRC_BUFFER_INPUT_HPP_
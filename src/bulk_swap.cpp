@@ -0,0 +1,197 @@
+#include "bulk_swap.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#include "byteswap.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define NBT_SWAP_X86
+  #include <immintrin.h>
+  #ifdef _MSC_VER
+    #include <intrin.h>
+  #endif
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+  #define NBT_SWAP_NEON
+  #include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+  #define NBT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+  #define NBT_TARGET_AVX2
+#endif
+
+namespace nbt {
+
+using SwapFunction = void (*)(char* destination, const char* source, size_t count);
+
+#ifndef NBT_BIG_ENDIAN
+
+namespace {
+
+void swap32Scalar(char* destination, const char* source, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    uint32_t value;
+    std::memcpy(&value, source + i * 4, 4);
+    value = bswap_32(value);
+    std::memcpy(destination + i * 4, &value, 4);
+  }
+}
+
+void swap64Scalar(char* destination, const char* source, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    uint64_t value;
+    std::memcpy(&value, source + i * 8, 8);
+    value = bswap_64(value);
+    std::memcpy(destination + i * 8, &value, 8);
+  }
+}
+
+#ifdef NBT_SWAP_X86
+
+inline __m128i swapBytes16Sse2(__m128i value) {
+  return _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+}
+
+void swap32Sse2(char* destination, const char* source, size_t count) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128i value = swapBytes16Sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4)));
+    value = _mm_shufflelo_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+    value = _mm_shufflehi_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4), value);
+  }
+  swap32Scalar(destination + i * 4, source + i * 4, count - i);
+}
+
+void swap64Sse2(char* destination, const char* source, size_t count) {
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    __m128i value = swapBytes16Sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 8)));
+    value = _mm_shufflelo_epi16(value, _MM_SHUFFLE(0, 1, 2, 3));
+    value = _mm_shufflehi_epi16(value, _MM_SHUFFLE(0, 1, 2, 3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 8), value);
+  }
+  swap64Scalar(destination + i * 8, source + i * 8, count - i);
+}
+
+NBT_TARGET_AVX2 void swapAvx2(char* destination, const char* source, size_t length, __m256i mask) {
+  size_t i = 0;
+  for (; i + 64 <= length; i += 64) {
+    __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+    __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i + 32));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_shuffle_epi8(first, mask));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i + 32), _mm256_shuffle_epi8(second, mask));
+  }
+  for (; i + 32 <= length; i += 32) {
+    __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_shuffle_epi8(value, mask));
+  }
+}
+
+NBT_TARGET_AVX2 void swap32Avx2(char* destination, const char* source, size_t count) {
+  const __m256i mask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+  size_t vectorCount = count & ~static_cast<size_t>(7);
+  swapAvx2(destination, source, vectorCount * 4, mask);
+  swap32Scalar(destination + vectorCount * 4, source + vectorCount * 4, count - vectorCount);
+}
+
+NBT_TARGET_AVX2 void swap64Avx2(char* destination, const char* source, size_t count) {
+  const __m256i mask = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                        7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  size_t vectorCount = count & ~static_cast<size_t>(3);
+  swapAvx2(destination, source, vectorCount * 8, mask);
+  swap64Scalar(destination + vectorCount * 8, source + vectorCount * 8, count - vectorCount);
+}
+
+bool hasAvx2() {
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) return false;
+  __cpuid(info, 1);
+  bool osxsave = (info[2] & (1 << 27)) != 0;
+  bool avx = (info[2] & (1 << 28)) != 0;
+  if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+
+SwapFunction selectSwap32() {
+  return hasAvx2() ? swap32Avx2 : swap32Sse2;
+}
+
+SwapFunction selectSwap64() {
+  return hasAvx2() ? swap64Avx2 : swap64Sse2;
+}
+
+#elif defined(NBT_SWAP_NEON)
+
+void swap32Neon(char* destination, const char* source, size_t count) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    uint8x16_t value = vld1q_u8(reinterpret_cast<const uint8_t*>(source + i * 4));
+    vst1q_u8(reinterpret_cast<uint8_t*>(destination + i * 4), vrev32q_u8(value));
+  }
+  swap32Scalar(destination + i * 4, source + i * 4, count - i);
+}
+
+void swap64Neon(char* destination, const char* source, size_t count) {
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    uint8x16_t value = vld1q_u8(reinterpret_cast<const uint8_t*>(source + i * 8));
+    vst1q_u8(reinterpret_cast<uint8_t*>(destination + i * 8), vrev64q_u8(value));
+  }
+  swap64Scalar(destination + i * 8, source + i * 8, count - i);
+}
+
+SwapFunction selectSwap32() {
+  return swap32Neon;
+}
+
+SwapFunction selectSwap64() {
+  return swap64Neon;
+}
+
+#else
+
+SwapFunction selectSwap32() {
+  return swap32Scalar;
+}
+
+SwapFunction selectSwap64() {
+  return swap64Scalar;
+}
+
+#endif
+
+} // namespace
+
+void networkCopy32(void* destination, const void* source, size_t count) {
+  static const SwapFunction swap = selectSwap32();
+  swap(static_cast<char*>(destination), static_cast<const char*>(source), count);
+}
+
+void networkCopy64(void* destination, const void* source, size_t count) {
+  static const SwapFunction swap = selectSwap64();
+  swap(static_cast<char*>(destination), static_cast<const char*>(source), count);
+}
+
+#else
+
+void networkCopy32(void* destination, const void* source, size_t count) {
+  if (destination != source) std::memcpy(destination, source, count * 4);
+}
+
+void networkCopy64(void* destination, const void* source, size_t count) {
+  if (destination != source) std::memcpy(destination, source, count * 8);
+}
+
+#endif
+
+} // namespace nbt
@@ -0,0 +1,22 @@
+#ifndef NBT_SRC_BULK_SWAP_HPP_
+#define NBT_SRC_BULK_SWAP_HPP_
+
+#include <cstddef>
+
+namespace nbt {
+
+/**
+ * Copies count 32-bit values from source to destination, converting between host and network byte order.
+ * Source and destination may be identical, but must not otherwise overlap.
+ */
+void networkCopy32(void* destination, const void* source, size_t count);
+
+/**
+ * Copies count 64-bit values from source to destination, converting between host and network byte order.
+ * Source and destination may be identical, but must not otherwise overlap.
+ */
+void networkCopy64(void* destination, const void* source, size_t count);
+
+} // namespace nbt
+
+#endif //NBT_SRC_BULK_SWAP_HPP_
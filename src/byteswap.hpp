@@ -41,6 +41,10 @@
 #define bswap_64(x) bswap64(x)
 #endif
 
+#elif defined(__linux__) || defined(__GLIBC__) || defined(__CYGWIN__)
+
+#include <byteswap.h>
+
 #else
 
 #error "no byteswap function"
@@ -0,0 +1,224 @@
+#ifndef NBT_SRC_CODEC_HPP_
+#define NBT_SRC_CODEC_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include "bulk_swap.hpp"
+#include "byteswap.hpp"
+
+namespace nbt {
+
+/**
+ * Converts count values to network byte order, from source into destination. Both may be identical.
+ */
+template<typename T>
+inline void networkCopy(T* destination, const T* source, size_t count) {
+  if constexpr (sizeof(T) == 1) {
+    if (destination != source) std::memcpy(destination, source, count);
+  } else if constexpr (sizeof(T) == 2) {
+    for (size_t i = 0; i < count; i++) {
+      uint16_t bits;
+      std::memcpy(&bits, source + i, sizeof(bits));
+      bits = hostToNetwork16(bits);
+      std::memcpy(destination + i, &bits, sizeof(bits));
+    }
+  } else if constexpr (sizeof(T) == 4) {
+    networkCopy32(destination, source, count);
+  } else {
+    static_assert(sizeof(T) == 8);
+    networkCopy64(destination, source, count);
+  }
+}
+
+/**
+ * Fixed width values in network byte order, as Java Edition stores them.
+ */
+struct BigEndian {
+  template<typename T>
+  static T load(const char* data) {
+    T value;
+    if constexpr (sizeof(T) == 1) {
+      std::memcpy(&value, data, sizeof(T));
+    } else if constexpr (sizeof(T) == 2) {
+      uint16_t bits;
+      std::memcpy(&bits, data, sizeof(bits));
+      bits = hostToNetwork16(bits);
+      std::memcpy(&value, &bits, sizeof(T));
+    } else if constexpr (sizeof(T) == 4) {
+      uint32_t bits;
+      std::memcpy(&bits, data, sizeof(bits));
+      bits = hostToNetwork32(bits);
+      std::memcpy(&value, &bits, sizeof(T));
+    } else {
+      static_assert(sizeof(T) == 8);
+      uint64_t bits;
+      std::memcpy(&bits, data, sizeof(bits));
+      bits = hostToNetwork64(bits);
+      std::memcpy(&value, &bits, sizeof(T));
+    }
+    return value;
+  }
+
+  template<typename T>
+  static void store(char* data, T value) {
+    if constexpr (sizeof(T) == 1) {
+      std::memcpy(data, &value, sizeof(T));
+    } else if constexpr (sizeof(T) == 2) {
+      uint16_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      bits = hostToNetwork16(bits);
+      std::memcpy(data, &bits, sizeof(bits));
+    } else if constexpr (sizeof(T) == 4) {
+      uint32_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      bits = hostToNetwork32(bits);
+      std::memcpy(data, &bits, sizeof(bits));
+    } else {
+      static_assert(sizeof(T) == 8);
+      uint64_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      bits = hostToNetwork64(bits);
+      std::memcpy(data, &bits, sizeof(bits));
+    }
+  }
+
+  /**
+   * Converts count values between host and this byte order, from source into destination. Both may be identical.
+   */
+  template<typename T>
+  static void convert(T* destination, const T* source, size_t count) {
+    networkCopy(destination, source, count);
+  }
+};
+
+/**
+ * Fixed width values in little-endian byte order, as Bedrock Edition stores them.
+ */
+struct LittleEndian {
+  template<typename T>
+  static T load(const char* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+#ifdef NBT_BIG_ENDIAN
+    swap(&value, &value, 1);
+#endif
+    return value;
+  }
+
+  template<typename T>
+  static void store(char* data, T value) {
+#ifdef NBT_BIG_ENDIAN
+    swap(&value, &value, 1);
+#endif
+    std::memcpy(data, &value, sizeof(T));
+  }
+
+  template<typename T>
+  static void convert(T* destination, const T* source, size_t count) {
+#ifdef NBT_BIG_ENDIAN
+    swap(destination, source, count);
+#else
+    if (destination != source && count != 0) std::memcpy(destination, source, count * sizeof(T));
+#endif
+  }
+ private:
+#ifdef NBT_BIG_ENDIAN
+  template<typename T>
+  static void swap(T* destination, const T* source, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+      char bytes[sizeof(T)];
+      std::memcpy(bytes, source + i, sizeof(T));
+      for (size_t j = 0; j < sizeof(T) / 2; j++) std::swap(bytes[j], bytes[sizeof(T) - 1 - j]);
+      std::memcpy(destination + i, bytes, sizeof(T));
+    }
+  }
+#endif
+};
+
+/**
+ * Codec policies describe how a variant of the format encodes tags. Decoder and Encoder are specialized on them at
+ * compile time, so the variants share one implementation without branching on the format while decoding.
+ */
+struct JavaCodec {
+  using ByteOrder = BigEndian;
+  static constexpr bool NAMED_ROOT = true;    // The root tag carries a name
+  static constexpr bool VARINTS = false;      // INT and LONG payloads and lengths are zig-zag varints
+  static constexpr bool MODIFIED_UTF = true;  // Strings are modified UTF-8 rather than UTF-8
+};
+
+/**
+ * Java Edition network protocol since 1.20.2: the root compound is sent without a name.
+ */
+struct JavaNetworkCodec : JavaCodec {
+  static constexpr bool NAMED_ROOT = false;
+};
+
+/**
+ * Bedrock Edition files: little-endian, with UTF-8 strings.
+ */
+struct BedrockCodec {
+  using ByteOrder = LittleEndian;
+  static constexpr bool NAMED_ROOT = true;
+  static constexpr bool VARINTS = false;
+  static constexpr bool MODIFIED_UTF = false;
+};
+
+/**
+ * Bedrock Edition network protocol: like BedrockCodec, but INT and LONG payloads, the elements of INT_ARRAY and
+ * LONG_ARRAY and every length are varints, zig-zag encoded except for the lengths of names and strings.
+ */
+struct BedrockNetworkCodec : BedrockCodec {
+  static constexpr bool VARINTS = true;
+};
+
+inline uint64_t zigZagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t zigZagDecode(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+inline size_t getVarintSize(uint64_t value) {
+  size_t size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    size++;
+  }
+  return size;
+}
+
+/**
+ * Encodes value in 7-bit groups, least significant first, at out.
+ * @return Returns the position after the encoded value.
+ */
+inline char* storeVarint(char* out, uint64_t value) {
+  while (value >= 0x80) {
+    *out++ = static_cast<char>(value | 0x80);
+    value >>= 7;
+  }
+  *out++ = static_cast<char>(value);
+  return out;
+}
+
+/**
+ * Decodes a varint of at most maxBytes bytes.
+ */
+template<typename Input>
+inline uint64_t readVarint(Input& in, size_t maxBytes) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < maxBytes; i++) {
+    auto byte = in.template readPrimitive<uint8_t>();
+    value |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+    if ((byte & 0x80) == 0) return value;
+  }
+  throw std::runtime_error("malformed nbt varint");
+}
+
+} // namespace nbt
+
+#endif //NBT_SRC_CODEC_HPP_
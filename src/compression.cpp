@@ -0,0 +1,243 @@
+#include "compression.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+#ifdef NBT_ZLIB
+  #include <zlib.h>
+#endif
+
+namespace nbt {
+
+#ifdef NBT_ZLIB
+
+struct InflateInput::Stream {
+  z_stream stream{};
+};
+
+constexpr int GZIP_OR_ZLIB_WINDOW = 15 + 32;  // Largest window, header detected automatically
+
+InflateInput::InflateInput(const char* data, size_t length) : m_Stream(std::make_unique<Stream>()), m_Source(nullptr), m_Window(std::make_unique<char[]>(WINDOW_SIZE)), m_Position(nullptr), m_End(nullptr), m_Finished(false) {
+  if (length > UINT32_MAX) throw std::runtime_error("compressed nbt buffer too large");  // zlib counts input in uInt
+  if (inflateInit2(&m_Stream->stream, GZIP_OR_ZLIB_WINDOW) != Z_OK) throw std::runtime_error("failed to initialize inflate stream");
+
+  m_Stream->stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+  m_Stream->stream.avail_in = static_cast<uInt>(length);
+  m_Position = m_End = m_Window.get();
+}
+
+InflateInput::InflateInput(std::istream& in) : m_Stream(std::make_unique<Stream>()), m_Source(&in), m_Input(std::make_unique<char[]>(WINDOW_SIZE)), m_Window(std::make_unique<char[]>(WINDOW_SIZE)), m_Position(nullptr), m_End(nullptr), m_Finished(false) {
+  if (inflateInit2(&m_Stream->stream, GZIP_OR_ZLIB_WINDOW) != Z_OK) throw std::runtime_error("failed to initialize inflate stream");
+  m_Position = m_End = m_Window.get();
+}
+
+InflateInput::~InflateInput() {
+  inflateEnd(&m_Stream->stream);
+}
+
+size_t InflateInput::inflateInto(char* destination, size_t length) {
+  z_stream& stream = m_Stream->stream;
+  stream.next_out = reinterpret_cast<Bytef*>(destination);
+  stream.avail_out = static_cast<uInt>(length);
+
+  while (stream.avail_out != 0 && !m_Finished) {
+    if (stream.avail_in == 0 && m_Source != nullptr) {
+      m_Source->read(m_Input.get(), static_cast<std::streamsize>(WINDOW_SIZE));
+      stream.next_in = reinterpret_cast<Bytef*>(m_Input.get());
+      stream.avail_in = static_cast<uInt>(m_Source->gcount());
+    }
+    if (stream.avail_in == 0) throw std::runtime_error("unexpected end of compressed nbt data");
+
+    int result = inflate(&stream, Z_NO_FLUSH);
+    if (result == Z_STREAM_END) {
+      m_Finished = true;
+    } else if (result != Z_OK) {
+      throw std::runtime_error("invalid compressed nbt data");
+    }
+  }
+
+  return length - stream.avail_out;
+}
+
+void InflateInput::finish() {
+  if (m_Source == nullptr) return;
+
+  z_stream& stream = m_Stream->stream;
+  while (!m_Finished) {
+    if (stream.avail_in == 0) {
+      m_Source->read(m_Input.get(), static_cast<std::streamsize>(WINDOW_SIZE));
+      stream.next_in = reinterpret_cast<Bytef*>(m_Input.get());
+      stream.avail_in = static_cast<uInt>(m_Source->gcount());
+      if (stream.avail_in == 0) return;  // Truncated, the document itself was complete
+    }
+
+    stream.next_out = reinterpret_cast<Bytef*>(m_Window.get());
+    stream.avail_out = static_cast<uInt>(WINDOW_SIZE);
+    int result = inflate(&stream, Z_NO_FLUSH);
+    if (result == Z_STREAM_END) {
+      m_Finished = true;
+    } else if (result != Z_OK) {
+      return;
+    }
+  }
+  m_Position = m_End = m_Window.get();
+  if (stream.avail_in == 0) return;
+
+  std::ios::iostate state = m_Source->rdstate();
+  m_Source->clear();
+  m_Source->seekg(-static_cast<std::streamoff>(stream.avail_in), std::ios::cur);
+  if (m_Source->fail()) {
+    m_Source->clear(state);
+    return;
+  }
+  stream.avail_in = 0;
+}
+
+#else
+
+struct InflateInput::Stream {};
+
+InflateInput::InflateInput(const char*, size_t) : m_Source(nullptr), m_Position(nullptr), m_End(nullptr), m_Finished(true) {
+  throw std::runtime_error("nbt compression support is not enabled");
+}
+
+InflateInput::InflateInput(std::istream&) : InflateInput(nullptr, 0) {}
+
+InflateInput::~InflateInput() = default;
+
+size_t InflateInput::inflateInto(char*, size_t) {
+  return 0;
+}
+
+void InflateInput::finish() {}
+
+#endif
+
+bool InflateInput::fill() {
+  size_t length = inflateInto(m_Window.get(), WINDOW_SIZE);
+  m_Position = m_Window.get();
+  m_End = m_Position + length;
+  return length != 0;
+}
+
+void InflateInput::readSlow(char* destination, size_t length) {
+  while (length != 0) {
+    size_t available = static_cast<size_t>(m_End - m_Position);
+    if (available == 0) {
+      if (length >= WINDOW_SIZE) {
+        size_t count = std::min<size_t>(length, UINT32_MAX);  // zlib counts output in uInt
+        if (inflateInto(destination, count) != count) throw std::runtime_error("unexpected end of nbt data");
+        destination += count;
+        length -= count;
+        continue;
+      }
+      if (!fill()) throw std::runtime_error("unexpected end of nbt data");
+      continue;
+    }
+
+    size_t count = std::min(available, length);
+    std::memcpy(destination, m_Position, count);
+    m_Position += count;
+    destination += count;
+    length -= count;
+  }
+}
+
+void InflateInput::skip(size_t length) {
+  while (length != 0) {
+    if (m_Position == m_End && !fill()) throw std::runtime_error("unexpected end of nbt data");
+
+    size_t count = std::min(static_cast<size_t>(m_End - m_Position), length);
+    m_Position += count;
+    length -= count;
+  }
+}
+
+void inflateTo(std::vector<char>& out, const char* data, size_t length) {
+  InflateInput in(data, length);
+  while (in.peek() != EOF) {
+    size_t available = in.available();
+    size_t offset = out.size();
+    out.resize(offset + available);
+    in.read(out.data() + offset, available);
+  }
+}
+
+#ifdef NBT_ZLIB
+
+void deflateTo(std::ostream& out, const char* data, size_t length, Compression compression) {
+  if (compression == Compression::NONE) {
+    out.write(data, static_cast<std::streamsize>(length));
+    return;
+  }
+
+  z_stream stream{};
+  int windowBits = compression == Compression::GZIP ? 15 + 16 : 15;
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) throw std::runtime_error("failed to initialize deflate stream");
+
+  auto window = std::make_unique<char[]>(InflateInput::WINDOW_SIZE);
+  int result = Z_OK;
+  while (result != Z_STREAM_END) {
+    if (stream.avail_in == 0 && length != 0) {
+      auto count = static_cast<uInt>(std::min<size_t>(length, UINT32_MAX));
+      stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+      stream.avail_in = count;
+      data += count;
+      length -= count;
+    }
+
+    stream.next_out = reinterpret_cast<Bytef*>(window.get());
+    stream.avail_out = static_cast<uInt>(InflateInput::WINDOW_SIZE);
+    result = deflate(&stream, length == 0 ? Z_FINISH : Z_NO_FLUSH);
+    if (result == Z_STREAM_ERROR) {
+      deflateEnd(&stream);
+      throw std::runtime_error("failed to compress nbt data");
+    }
+
+    out.write(window.get(), static_cast<std::streamsize>(InflateInput::WINDOW_SIZE - stream.avail_out));
+  }
+
+  deflateEnd(&stream);
+}
+
+void deflateTo(std::vector<char>& out, const char* data, size_t length, Compression compression) {
+  size_t offset = out.size();
+  if (compression == Compression::NONE) {
+    out.insert(out.end(), data, data + length);
+    return;
+  }
+  if (length > UINT32_MAX) throw std::runtime_error("nbt data too large to compress into a buffer");  // zlib counts in uInt
+
+  z_stream stream{};
+  int windowBits = compression == Compression::GZIP ? 15 + 16 : 15;
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) throw std::runtime_error("failed to initialize deflate stream");
+
+  out.resize(offset + deflateBound(&stream, static_cast<uLong>(length)));  // Deflates in a single call
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+  stream.avail_in = static_cast<uInt>(length);
+  stream.next_out = reinterpret_cast<Bytef*>(out.data() + offset);
+  stream.avail_out = static_cast<uInt>(out.size() - offset);
+
+  int result = deflate(&stream, Z_FINISH);
+  deflateEnd(&stream);
+  if (result != Z_STREAM_END) throw std::runtime_error("failed to compress nbt data");
+
+  out.resize(out.size() - stream.avail_out);
+}
+
+#else
+
+void deflateTo(std::ostream& out, const char* data, size_t length, Compression compression) {
+  if (compression != Compression::NONE) throw std::runtime_error("nbt compression support is not enabled");
+  out.write(data, static_cast<std::streamsize>(length));
+}
+
+void deflateTo(std::vector<char>& out, const char* data, size_t length, Compression compression) {
+  if (compression != Compression::NONE) throw std::runtime_error("nbt compression support is not enabled");
+  out.insert(out.end(), data, data + length);
+}
+
+#endif
+
+} // namespace nbt
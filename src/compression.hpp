@@ -0,0 +1,162 @@
+#ifndef NBT_SRC_COMPRESSION_HPP_
+#define NBT_SRC_COMPRESSION_HPP_
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "nbt/nbt_type.hpp"
+#include "nbt/nbt_writer.hpp"
+#include "primitive.hpp"
+
+namespace nbt {
+
+/**
+ * Identifies gzip and zlib streams by their header. Raw documents start with a tag type, which never collides with
+ * either header. Only the first byte is inspected when length is 1, as for streams that cannot be rewound further.
+ */
+inline Compression detectCompression(const char* header, size_t length) {
+  if (length == 0) return Compression::NONE;
+
+  auto first = static_cast<uint8_t>(header[0]);
+  if (first == 0x1F) {
+    if (length == 1 || static_cast<uint8_t>(header[1]) == 0x8B) return Compression::GZIP;
+  } else if ((first & 0x0F) == 8 && first > 0x0F && first <= 0x78) {  // Deflate with a 512 byte to 32 KB window
+    if (length == 1 || (first << 8 | static_cast<uint8_t>(header[1])) % 31 == 0) return Compression::ZLIB;
+  }
+  return Compression::NONE;
+}
+
+/**
+ * Input that inflates a gzip or zlib stream one window at a time, so that decoding starts before the whole document is
+ * decompressed and the inflated document never has to be held in memory. Reads larger than the window inflate straight
+ * into their destination.
+ */
+class InflateInput {
+ public:
+  static constexpr size_t WINDOW_SIZE = 64 * 1024;
+  static constexpr bool BOUNDED = false;
+
+  InflateInput(const char* data, size_t length);
+  explicit InflateInput(std::istream& in);
+  ~InflateInput();
+
+  InflateInput(const InflateInput&) = delete;
+  InflateInput& operator=(const InflateInput&) = delete;
+
+  void read(char* destination, size_t length) {
+    size_t available = static_cast<size_t>(m_End - m_Position);
+    if (length <= available) {
+      std::memcpy(destination, m_Position, length);
+      m_Position += length;
+      return;
+    }
+    readSlow(destination, length);
+  }
+
+  /**
+   * Advances the cursor by length bytes.
+   * @return Returns the bytes, valid until the next read from this input.
+   */
+  const char* consume(size_t length) {
+    if (static_cast<size_t>(m_End - m_Position) >= length) {
+      const char* position = m_Position;
+      m_Position += length;
+      return position;
+    }
+
+    m_Scratch.resize(length);  // The bytes straddle two windows
+    readSlow(m_Scratch.data(), length);
+    return m_Scratch.data();
+  }
+
+  void skip(size_t length);
+
+  /**
+   * The inflated length is unknown up front, short reads are detected by read() instead.
+   */
+  void require(size_t) const {}
+
+  template<typename T, typename Codec = JavaCodec>
+  T readPrimitive() {
+    if (static_cast<size_t>(m_End - m_Position) >= sizeof(T)) {
+      T value = Primitive<T, Codec>::load(m_Position);
+      m_Position += sizeof(T);
+      return value;
+    }
+
+    char bytes[Primitive<T, Codec>::getSize()];
+    readSlow(bytes, sizeof(bytes));
+    return Primitive<T, Codec>::load(bytes);
+  }
+
+  Type readType() {
+    return static_cast<Type>(readPrimitive<int8_t>());
+  }
+
+  int peek() {
+    if (m_Position == m_End && !fill()) return EOF;
+    return static_cast<uint8_t>(*m_Position);
+  }
+
+  /**
+   * @return Returns the number of bytes left in the current window.
+   */
+  [[nodiscard]] size_t available() const {
+    return static_cast<size_t>(m_End - m_Position);
+  }
+
+  /**
+   * Reads the rest of the compressed member, discarding what it inflates to, and hands the input read past its end back
+   * to the source stream. Only seekable streams can take input back, others stay positioned after the read-ahead.
+   */
+  void finish();
+ private:
+  struct Stream;
+
+  void readSlow(char* destination, size_t length);
+
+  /**
+   * Inflates into destination until it is full or the compressed stream ends.
+   * @return Returns the number of bytes inflated.
+   */
+  size_t inflateInto(char* destination, size_t length);
+
+  /**
+   * Refills the window.
+   * @return Returns false if the compressed stream has ended.
+   */
+  bool fill();
+
+  std::unique_ptr<Stream> m_Stream;
+  std::istream* m_Source;
+  std::unique_ptr<char[]> m_Input;
+  std::unique_ptr<char[]> m_Window;
+  const char* m_Position;
+  const char* m_End;
+  bool m_Finished;
+  std::vector<char> m_Scratch;
+};
+
+/**
+ * Inflates a whole gzip or zlib stream, appending it to out.
+ */
+void inflateTo(std::vector<char>& out, const char* data, size_t length);
+
+/**
+ * Compresses data into out in window sized chunks.
+ */
+void deflateTo(std::ostream& out, const char* data, size_t length, Compression compression);
+
+/**
+ * Compresses data, appending it to out.
+ */
+void deflateTo(std::vector<char>& out, const char* data, size_t length, Compression compression);
+
+} // namespace nbt
+
+#endif //NBT_SRC_COMPRESSION_HPP_
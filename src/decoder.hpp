@@ -0,0 +1,454 @@
+#ifndef NBT_SRC_DECODER_HPP_
+#define NBT_SRC_DECODER_HPP_
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "budget.hpp"
+#include "buffer_input.hpp"
+#include "modified_utf.hpp"
+#include "nbt/nbt_path.hpp"
+#include "nbt/nbt_thread_pool.hpp"
+#include "nbt/nbt_type.hpp"
+#include "primitive.hpp"
+
+namespace nbt {
+
+/**
+ * Decodes tags from an input: a BufferInput, StreamInput or InflateInput, in the variant of the format Codec describes.
+ */
+template<typename Input, typename Codec = JavaCodec>
+class Decoder {
+ public:
+  /**
+   * @param keys Table compound keys are interned into, or nullptr to give every compound its own keys.
+   */
+  Decoder(Input& in, std::pmr::memory_resource* resource, KeyTable* keys = nullptr) : m_Input(in), m_Resource(resource), m_Keys(keys), m_Pool(nullptr), m_ParallelThreshold(0) {}
+
+  /**
+   * Decodes the elements of lists and the entries of compounds that span at least threshold bytes on pool. Only buffer
+   * inputs, which can be scanned ahead, decode in parallel.
+   */
+  void setParallel(ThreadPool* pool, size_t threshold) {
+    m_Pool = pool;
+    m_ParallelThreshold = threshold;
+  }
+
+  /**
+   * Enforces limits while decoding. Limited decoders decode serially, so that one budget covers the whole document.
+   */
+  void setLimits(const ReaderLimits& limits) {
+    m_Budget = Budget(limits);
+    m_Pool = nullptr;
+  }
+
+  /**
+   * Reads named tags until the end of the input or a TAG_End, which is left unconsumed. Codecs without a named root
+   * read a single tag, which is stored under an empty name.
+   */
+  Compound readDocument() {
+    Compound compound(m_Resource);
+    while (true) {
+      int peek = m_Input.peek();
+      if (peek == EOF) break;
+      if (peek == 0) break; // TAG_End
+
+      Type type = m_Input.readType();
+      if constexpr (!Codec::NAMED_ROOT) {
+        compound.insert(createKey({}), readValue(type));
+        break;
+      }
+      readNextPair(compound, type);
+    }
+    return compound;
+  }
+
+  Value readValue(Type type) {
+    m_Budget.charge(1, sizeof(Value));
+    switch (type) {
+      case Type::BYTE: return Primitive<int8_t, Codec>::readFrom(m_Input);
+      case Type::SHORT: return Primitive<int16_t, Codec>::readFrom(m_Input);
+      case Type::INT: return Primitive<int32_t, Codec>::readFrom(m_Input);
+      case Type::LONG: return Primitive<int64_t, Codec>::readFrom(m_Input);
+      case Type::FLOAT: return Primitive<float, Codec>::readFrom(m_Input);
+      case Type::DOUBLE: return Primitive<double, Codec>::readFrom(m_Input);
+      case Type::BYTE_ARRAY: return readArray<int8_t>();
+      case Type::INT_ARRAY: return readArray<int32_t>();
+      case Type::LONG_ARRAY: return readArray<int64_t>();
+      case Type::STRING: return readString();
+      case Type::LIST: return readList();
+      case Type::COMPOUND: return readCompound();
+      default:throw std::runtime_error("invalid nbt type");
+    }
+  }
+
+  List readList() {
+    Type listType = m_Input.readType();
+    auto arrayLength = Primitive<int32_t, Codec>::readFrom(m_Input);
+    if (static_cast<Type>(0) == listType) return List(static_cast<Type>(0), m_Resource);
+
+    List list(listType, m_Resource);
+    size_t length = arrayLength > 0 ? static_cast<size_t>(arrayLength) : 0;
+    m_Budget.checkLength(length);
+    if (size_t elementSize = fixedPayloadSize(listType); elementSize != 0) {
+      m_Budget.charge(length, length * elementSize);
+    }
+
+    m_Budget.enter();
+    switch (listType) {  // Primitive elements are read in bulk into the list's typed storage
+      case Type::BYTE: Array<int8_t, Codec>::readElements(m_Input, list.getBytes(), length);
+        break;
+      case Type::SHORT: Array<int16_t, Codec>::readElements(m_Input, list.getShorts(), length);
+        break;
+      case Type::INT: Array<int32_t, Codec>::readElements(m_Input, list.getInts(), length);
+        break;
+      case Type::LONG: Array<int64_t, Codec>::readElements(m_Input, list.getLongs(), length);
+        break;
+      case Type::FLOAT: Array<float, Codec>::readElements(m_Input, list.getFloats(), length);
+        break;
+      case Type::DOUBLE: Array<double, Codec>::readElements(m_Input, list.getDoubles(), length);
+        break;
+      default:
+        if constexpr (std::is_same_v<Input, BufferInput>) {
+          if (m_Pool != nullptr && length > 1 && readListParallel(list, listType, length)) break;
+        }
+        for (size_t i = 0; i < length; i++) {
+          list.pushBack(readValue(listType));
+        }
+    }
+    m_Budget.leave();
+    return list;
+  }
+
+  Compound readCompound() {
+    Compound compound(m_Resource);
+    if constexpr (std::is_same_v<Input, BufferInput>) {
+      if (m_Pool != nullptr && readCompoundParallel(compound)) return compound;
+    }
+
+    m_Budget.enter();
+    Type type = m_Input.readType();
+    while (type != static_cast<Type>(0)) {
+      readNextPair(compound, type);
+      type = m_Input.readType();
+    }
+    m_Budget.leave();
+    return compound;
+  }
+
+  void readNextPair(Compound& compound, Type type) {
+    std::string_view name = readName();
+    m_Budget.charge(0, name.size());
+    Key key = createKey(name);
+    compound.insert(std::move(key), readValue(type));
+  }
+
+  /**
+   * Like readDocument(), but only materializes the tags selected by paths and skips over everything else.
+   */
+  Compound readDocument(const PathSet::Node& paths) {
+    Compound compound(m_Resource);
+    while (true) {
+      int peek = m_Input.peek();
+      if (peek == EOF || peek == 0) break;
+
+      Type type = m_Input.readType();
+      if constexpr (!Codec::NAMED_ROOT) {
+        readSelectedPair(compound, type, {}, paths);
+        break;
+      }
+      readSelectedPair(compound, type, readName(), paths);
+    }
+    return compound;
+  }
+
+  void readSelectedPair(Compound& compound, Type type, std::string_view name, const PathSet::Node& parent) {
+    const PathSet::Node* node = parent.findKey(name);
+    if (node == nullptr || !(node->selected || type == Type::COMPOUND || type == Type::LIST)) {
+      skipPayload<Codec>(m_Input, type, m_Budget.getDepthLeft());
+      return;
+    }
+
+    m_Budget.charge(0, name.size());
+    Key key = createKey(name);
+    compound.insert(std::move(key), readSelectedValue(type, *node));
+  }
+
+  Value readSelectedValue(Type type, const PathSet::Node& node) {
+    if (node.selected) return readValue(type);
+
+    m_Budget.charge(1, sizeof(Value));
+    if (type == Type::COMPOUND) return readSelectedCompound(node);
+    return readSelectedList(node);
+  }
+
+  Compound readSelectedCompound(const PathSet::Node& node) {
+    Compound compound(m_Resource);
+    m_Budget.enter();
+    Type type = m_Input.readType();
+    while (type != static_cast<Type>(0)) {
+      readSelectedPair(compound, type, readName(), node);
+      type = m_Input.readType();
+    }
+    m_Budget.leave();
+    return compound;
+  }
+
+  List readSelectedList(const PathSet::Node& node) {
+    Type listType = m_Input.readType();
+    auto arrayLength = Primitive<int32_t, Codec>::readFrom(m_Input);
+    if (static_cast<Type>(0) == listType) return List(static_cast<Type>(0), m_Resource);
+
+    List list(listType, m_Resource);
+    m_Budget.enter();
+    for (int32_t i = 0; i < arrayLength; i++) {
+      const PathSet::Node* element = node.findIndex(static_cast<size_t>(i));
+      if (element == nullptr || !(element->selected || listType == Type::COMPOUND || listType == Type::LIST)) {
+        skipPayload<Codec>(m_Input, listType, m_Budget.getDepthLeft());
+        continue;
+      }
+      list.pushBack(readSelectedValue(listType, *element));
+    }
+    m_Budget.leave();
+    return list;
+  }
+ private:
+  struct Payload {
+    Type type;
+    const char* begin;
+    const char* end;
+    std::string_view name;  // Empty for list elements
+  };
+
+  /**
+   * Children of the containers in [begin, end) that are decoded in parallel: those that span the threshold and have more
+   * than one child, keyed by where their elements or entries start. One scan of the outermost container that may span
+   * the threshold finds them all, so nested containers never scan their bytes again. A list of compounds starts where
+   * its first element does, hence the two maps.
+   */
+  struct Outline {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    std::unordered_map<const char*, std::vector<Payload>> lists;
+    std::unordered_map<const char*, std::vector<Payload>> compounds;
+    std::vector<Payload> pending;  // Children of the containers being scanned, innermost last
+  };
+
+  /**
+   * Decodes the list's elements on the pool if the outline splits the list, scanning the list first unless an enclosing
+   * container was scanned already. The input is left untouched otherwise.
+   * @return Returns whether the elements were decoded.
+   */
+  bool readListParallel(List& list, Type type, size_t length) {
+    if (!isOutlined()) {
+      if (m_Input.remaining() < m_ParallelThreshold) return false;
+      auto outline = std::make_shared<Outline>();
+      BufferInput scan = m_Input;
+      scanList(scan, type, length, *outline);
+      setOutline(std::move(outline), scan.position());
+    }
+
+    const std::vector<Payload>* payloads = findSplit(m_Outline->lists);
+    if (payloads == nullptr) return false;
+
+    std::vector<Value> values = readPayloads(*payloads);
+    m_Input.skip(static_cast<size_t>(payloads->back().end - m_Input.position()));
+    for (auto& value : values) list.pushBack(std::move(value));
+    return true;
+  }
+
+  /**
+   * Like readListParallel(), for the entries of a compound. Keys are created in order once the values are decoded.
+   */
+  bool readCompoundParallel(Compound& compound) {
+    if (!isOutlined()) {
+      if (m_Input.remaining() < m_ParallelThreshold) return false;
+      auto outline = std::make_shared<Outline>();
+      BufferInput scan = m_Input;
+      scanCompound(scan, *outline);
+      setOutline(std::move(outline), scan.position());
+    }
+
+    const std::vector<Payload>* payloads = findSplit(m_Outline->compounds);
+    if (payloads == nullptr) return false;
+
+    std::vector<Value> values = readPayloads(*payloads);
+    m_Input.skip(static_cast<size_t>(payloads->back().end - m_Input.position()) + 1);  // And the TAG_End
+    compound.reserve(values.size());
+    for (size_t i = 0; i < values.size(); i++) compound.insert(createKey((*payloads)[i].name), std::move(values[i]));
+    return true;
+  }
+
+  [[nodiscard]] bool isOutlined() const {
+    return m_Outline != nullptr && m_Input.position() >= m_Outline->begin && m_Input.position() < m_Outline->end;
+  }
+
+  void setOutline(std::shared_ptr<Outline> outline, const char* end) {
+    outline->begin = m_Input.position();
+    outline->end = end;
+    outline->pending = {};
+    m_Outline = std::move(outline);
+  }
+
+  /**
+   * @return Returns the children of the container in splits whose elements or entries start at the input's position, or
+   * nullptr if it is decoded serially.
+   */
+  const std::vector<Payload>* findSplit(const std::unordered_map<const char*, std::vector<Payload>>& splits) const {
+    auto split = splits.find(m_Input.position());
+    return split == splits.end() ? nullptr : &split->second;
+  }
+
+  /**
+   * Moves scan past a payload like skipPayload(), adding the lists and compounds inside it to outline.
+   */
+  void scanPayload(BufferInput& scan, Type type, Outline& outline) {
+    if (type == Type::COMPOUND) {
+      scanCompound(scan, outline);
+    } else if (type == Type::LIST) {
+      Type elementType = scan.readType();
+      auto length = Primitive<int32_t, Codec>::readFrom(scan);
+      scanList(scan, elementType, length > 0 ? static_cast<size_t>(length) : 0, outline);
+    } else {
+      skipPayload<Codec>(scan, type);
+    }
+  }
+
+  void scanList(BufferInput& scan, Type type, size_t length, Outline& outline) {
+    if (static_cast<Type>(0) == type || length == 0) return;
+    if (size_t elementSize = fixedPayloadSize<Codec>(type); elementSize != 0) {
+      scan.skip(length * elementSize);  // Read in bulk, never split
+      return;
+    }
+    if (length > scan.remaining()) throw std::runtime_error("unexpected end of nbt data");  // Elements take a byte or more
+
+    const char* begin = scan.position();
+    size_t first = outline.pending.size();
+    for (size_t i = 0; i < length; i++) {
+      const char* element = scan.position();
+      scanPayload(scan, type, outline);
+      outline.pending.push_back({type, element, scan.position(), {}});
+    }
+    addSplit(outline.lists, outline, begin, scan.position(), first);
+  }
+
+  void scanCompound(BufferInput& scan, Outline& outline) {
+    const char* begin = scan.position();
+    size_t first = outline.pending.size();
+    for (Type type = scan.readType(); type != static_cast<Type>(0); type = scan.readType()) {
+      auto length = Primitive<uint16_t, Codec>::readFrom(scan);
+      std::string_view name(scan.consume(length), length);
+
+      const char* entry = scan.position();
+      scanPayload(scan, type, outline);
+      outline.pending.push_back({type, entry, scan.position(), name});
+    }
+    addSplit(outline.compounds, outline, begin, scan.position(), first);
+  }
+
+  /**
+   * Adds the children pending since first to splits, if the container spanning [begin, end) is worth splitting.
+   */
+  void addSplit(std::unordered_map<const char*, std::vector<Payload>>& splits, Outline& outline, const char* begin, const char* end, size_t first) {
+    auto children = outline.pending.begin() + static_cast<ptrdiff_t>(first);
+    if (static_cast<size_t>(end - begin) >= m_ParallelThreshold && outline.pending.end() - children > 1) {
+      splits.emplace(begin, std::vector<Payload>(children, outline.pending.end()));
+    }
+    outline.pending.erase(children, outline.pending.end());
+  }
+
+  /**
+   * Decodes payloads on the pool, in batches of consecutive payloads. Payloads that contain splits of the outline fan
+   * out further, as the pool allows nested runs.
+   */
+  std::vector<Value> readPayloads(const std::vector<Payload>& payloads) {
+    std::vector<Value> values(payloads.size());
+    size_t batches = std::min(payloads.size(), m_Pool->getConcurrency() * 8);
+    m_Pool->run(batches, [&](size_t batch) {
+      for (size_t i = payloads.size() * batch / batches; i < payloads.size() * (batch + 1) / batches; i++) {
+        BufferInput in(payloads[i].begin, payloads[i].end);
+        Decoder<BufferInput, Codec> decoder(in, m_Resource, m_Keys);
+        decoder.setParallel(m_Pool, m_ParallelThreshold);
+        decoder.m_Outline = m_Outline;
+        values[i] = decoder.readValue(payloads[i].type);
+      }
+    });
+    return values;
+  }
+
+  /**
+   * @return Returns the next length prefixed name, valid until the next read.
+   */
+  std::string_view readName() {
+    auto length = Primitive<uint16_t, Codec>::readFrom(m_Input);
+    if constexpr (HasConsume<Input>::value) {
+      return {m_Input.consume(length), length};
+    } else {
+      m_KeyBuffer.resize(length);
+      m_Input.read(m_KeyBuffer.data(), length);
+      return m_KeyBuffer;
+    }
+  }
+
+  /**
+   * Reads an array, checking its length against the budget before storage is allocated for its elements.
+   */
+  template<typename T>
+  std::pmr::vector<T> readArray() {
+    auto length = Primitive<int32_t, Codec>::readFrom(m_Input);
+    if (length < 0) throw std::runtime_error("negative nbt array length");
+
+    m_Budget.checkLength(static_cast<size_t>(length));
+    m_Budget.charge(0, static_cast<size_t>(length) * sizeof(T));
+
+    std::pmr::vector<T> values(m_Resource);
+    Array<T, Codec>::readElements(m_Input, values, static_cast<size_t>(length));
+    return values;
+  }
+
+  /**
+   * Strings are charged once decoded, as their length is bounded by the 16 bit length prefix.
+   */
+  String readString() {
+    if constexpr (Codec::MODIFIED_UTF) {
+      String string = utf::readUTF(m_Input, m_Resource);
+      m_Budget.charge(0, string.size());
+      return string;
+    }
+
+    auto length = Primitive<uint16_t, Codec>::readFrom(m_Input);
+    m_Budget.charge(0, length);
+    String string(m_Resource);
+    if constexpr (HasConsume<Input>::value) {
+      string.assign(m_Input.consume(length), length);
+    } else {
+      string.resize(length);
+      m_Input.read(string.data(), length);
+    }
+    return string;
+  }
+
+  Key createKey(std::string_view key) {
+    if (m_Keys != nullptr) return m_Keys->intern(key);
+    return Key(key, m_Resource);
+  }
+
+  Input& m_Input;
+  std::pmr::memory_resource* m_Resource;
+  KeyTable* m_Keys;
+  std::string m_KeyBuffer;
+  ThreadPool* m_Pool;
+  size_t m_ParallelThreshold;
+  std::shared_ptr<const Outline> m_Outline;
+  Budget m_Budget;
+};
+
+} // namespace nbt
+
+#endif //NBT_SRC_DECODER_HPP_
@@ -0,0 +1,205 @@
+#ifndef NBT_SRC_ENCODER_HPP_
+#define NBT_SRC_ENCODER_HPP_
+
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+#include "buffer_input.hpp"
+#include "modified_utf.hpp"
+#include "nbt/nbt_type.hpp"
+#include "primitive.hpp"
+
+namespace nbt {
+
+/**
+ * Encodes tags, in the variant of the format Codec describes, into a buffer presized with the getSize() functions. No
+ * bounds are checked while writing.
+ */
+template<typename Codec = JavaCodec>
+class Encoder {
+ public:
+  explicit Encoder(char* out) : m_Position(out) {}
+
+  void writeType(Type type) {
+    *m_Position++ = static_cast<char>(type);
+  }
+
+  void writeName(std::string_view name) {
+    m_Position = Primitive<uint16_t, Codec>::write(m_Position, static_cast<uint16_t>(name.size()));
+    std::memcpy(m_Position, name.data(), name.size());
+    m_Position += name.size();
+  }
+
+  template<typename T>
+  void writePrimitive(T value) {
+    m_Position = Primitive<T, Codec>::write(m_Position, value);
+  }
+
+  template<typename T>
+  void writeElements(const std::pmr::vector<T>& values) {
+    m_Position = Array<T, Codec>::storeElements(m_Position, values.data(), values.size());
+  }
+
+  template<typename T>
+  void writeArray(const std::pmr::vector<T>& values) {
+    writePrimitive(static_cast<int32_t>(values.size()));
+    writeElements(values);
+  }
+
+  void writeValue(const Value& value) {
+    switch (value.getType()) {
+      case Type::BYTE: writePrimitive(value.getByte());
+        break;
+      case Type::SHORT: writePrimitive(value.getShort());
+        break;
+      case Type::INT: writePrimitive(value.getInt());
+        break;
+      case Type::LONG: writePrimitive(value.getLong());
+        break;
+      case Type::FLOAT: writePrimitive(value.getFloat());
+        break;
+      case Type::DOUBLE: writePrimitive(value.getDouble());
+        break;
+      case Type::BYTE_ARRAY: writeArray(value.getByteArray());
+        break;
+      case Type::STRING: writeString(value.getString());
+        break;
+      case Type::LIST: writeList(value.getList());
+        break;
+      case Type::COMPOUND: writeCompound(value.getCompound());
+        break;
+      case Type::INT_ARRAY: writeArray(value.getIntArray());
+        break;
+      case Type::LONG_ARRAY: writeArray(value.getLongArray());
+        break;
+      default:throw std::runtime_error("invalid nbt type");
+    }
+  }
+
+  void writeList(const List& list) {
+    writeType(list.getType());
+    writePrimitive(static_cast<int32_t>(list.size()));
+    if (list.hasTypedStorage()) {
+      switch (list.getType()) {
+        case Type::BYTE: writeElements(list.getBytes());
+          break;
+        case Type::SHORT: writeElements(list.getShorts());
+          break;
+        case Type::INT: writeElements(list.getInts());
+          break;
+        case Type::LONG: writeElements(list.getLongs());
+          break;
+        case Type::FLOAT: writeElements(list.getFloats());
+          break;
+        case Type::DOUBLE: writeElements(list.getDoubles());
+          break;
+        default: break;
+      }
+      return;
+    }
+
+    for (const auto& element : list) {
+      writeValue(element);
+    }
+  }
+
+  void writeCompound(const Compound& compound) {
+    for (const auto& pair : compound) {
+      if (pair.second.getType() == static_cast<Type>(0)) continue;  // NULL-Pair
+      writeType(pair.second.getType());
+      writeName(pair.first);
+      writeValue(pair.second);
+    }
+    writeType(static_cast<Type>(0));  // TAG_End
+  }
+
+  void writeString(std::string_view string) {
+    if constexpr (Codec::MODIFIED_UTF) {
+      m_Position = utf::encodeUTF(m_Position, string);
+    } else {
+      writeName(string);
+    }
+  }
+
+  [[nodiscard]] char* position() const { return m_Position; }
+
+  /**
+   * @return Returns the encoded size of a named tag's name, including its length prefix.
+   */
+  static size_t getNameSize(std::string_view name) {
+    if (name.size() > UINT16_MAX) throw std::runtime_error("nbt name too long");
+    return Primitive<uint16_t, Codec>::getSize(static_cast<uint16_t>(name.size())) + name.size();
+  }
+
+  /**
+   * @return Returns the encoded size of a value's payload.
+   */
+  static size_t getSize(const Value& value) {
+    switch (value.getType()) {
+      case Type::BYTE:
+      case Type::SHORT:
+      case Type::FLOAT:
+      case Type::DOUBLE: return fixedPayloadSize(value.getType());
+      case Type::INT: return Primitive<int32_t, Codec>::getSize(value.getInt());
+      case Type::LONG: return Primitive<int64_t, Codec>::getSize(value.getLong());
+      case Type::BYTE_ARRAY: return getArraySize(value.getByteArray());
+      case Type::INT_ARRAY: return getArraySize(value.getIntArray());
+      case Type::LONG_ARRAY: return getArraySize(value.getLongArray());
+      case Type::STRING: return getStringSize(value.getString());
+      case Type::LIST: return getSize(value.getList());
+      case Type::COMPOUND: return getSize(value.getCompound());
+      default:throw std::runtime_error("invalid nbt type");
+    }
+  }
+
+  static size_t getSize(const List& list) {
+    if (list.size() > INT32_MAX) throw std::runtime_error("nbt list too long");
+    size_t size = 1 + Primitive<int32_t, Codec>::getSize(static_cast<int32_t>(list.size()));  // Element type and length
+    if (list.hasTypedStorage()) {
+      switch (list.getType()) {
+        case Type::INT: return size + getElementsSize(list.getInts());
+        case Type::LONG: return size + getElementsSize(list.getLongs());
+        default: return size + list.size() * fixedPayloadSize(list.getType());
+      }
+    }
+
+    for (const auto& element : list) {
+      size += getSize(element);
+    }
+    return size;
+  }
+
+  static size_t getSize(const Compound& compound) {
+    size_t size = 1;  // TAG_End
+    for (const auto& pair : compound) {
+      if (pair.second.getType() == static_cast<Type>(0)) continue;
+      size += 1 + getNameSize(pair.first) + getSize(pair.second);
+    }
+    return size;
+  }
+ private:
+  template<typename T>
+  static size_t getArraySize(const std::pmr::vector<T>& values) {
+    if (values.size() > INT32_MAX) throw std::runtime_error("nbt array too long");
+    return Primitive<int32_t, Codec>::getSize(static_cast<int32_t>(values.size())) + getElementsSize(values);
+  }
+
+  template<typename T>
+  static size_t getElementsSize(const std::pmr::vector<T>& values) {
+    return Array<T, Codec>::getSize(values.data(), values.size());
+  }
+
+  static size_t getStringSize(std::string_view string) {
+    if constexpr (Codec::MODIFIED_UTF) return utf::getByteLength(string);
+
+    if (string.size() > UINT16_MAX) throw std::runtime_error("encoded string too long");
+    return getNameSize(string);
+  }
+
+  char* m_Position;
+};
+
+} // namespace nbt
+
+#endif //NBT_SRC_ENCODER_HPP_
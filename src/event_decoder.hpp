@@ -0,0 +1,162 @@
+#ifndef NBT_SRC_EVENT_DECODER_HPP_
+#define NBT_SRC_EVENT_DECODER_HPP_
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "buffer_input.hpp"
+#include "modified_utf.hpp"
+#include "nbt/nbt_visitor.hpp"
+#include "primitive.hpp"
+
+namespace nbt {
+
+/**
+ * Decodes tags from an input straight into Visitor callbacks. Buffer inputs hand out views into the buffer, stream
+ * inputs go through scratch buffers that are reused between callbacks.
+ */
+template<typename Input>
+class EventDecoder {
+ public:
+  EventDecoder(Input& in, Visitor& visitor) : m_Input(in), m_Visitor(visitor) {}
+
+  /**
+   * Reads named tags until the end of the input or a TAG_End, which is left unconsumed.
+   */
+  void readDocument() {
+    while (true) {
+      int peek = m_Input.peek();
+      if (peek == EOF || peek == 0) break;
+
+      Type type = m_Input.readType();
+      readValue(type, readName());
+    }
+  }
+
+  void readValue(Type type, std::string_view name) {
+    switch (type) {
+      case Type::BYTE: m_Visitor.onByte(name, m_Input.template readPrimitive<int8_t>());
+        break;
+      case Type::SHORT: m_Visitor.onShort(name, m_Input.template readPrimitive<int16_t>());
+        break;
+      case Type::INT: m_Visitor.onInt(name, m_Input.template readPrimitive<int32_t>());
+        break;
+      case Type::LONG: m_Visitor.onLong(name, m_Input.template readPrimitive<int64_t>());
+        break;
+      case Type::FLOAT: m_Visitor.onFloat(name, m_Input.template readPrimitive<float>());
+        break;
+      case Type::DOUBLE: m_Visitor.onDouble(name, m_Input.template readPrimitive<double>());
+        break;
+      case Type::BYTE_ARRAY: m_Visitor.onByteArray(name, readArray<int8_t>());
+        break;
+      case Type::INT_ARRAY: m_Visitor.onIntArray(name, readArray<int32_t>());
+        break;
+      case Type::LONG_ARRAY: m_Visitor.onLongArray(name, readArray<int64_t>());
+        break;
+      case Type::STRING: m_Visitor.onString(name, readString());
+        break;
+      case Type::LIST: readList(name);
+        break;
+      case Type::COMPOUND: readCompound(name);
+        break;
+      default:throw std::runtime_error("invalid nbt type");
+    }
+  }
+
+  void readList(std::string_view name) {
+    Type elementType = m_Input.readType();
+    auto arrayLength = m_Input.template readPrimitive<int32_t>();
+    size_t length = elementType == static_cast<Type>(0) || arrayLength < 0 ? 0 : static_cast<size_t>(arrayLength);
+
+    if (!m_Visitor.onListBegin(name, elementType, length)) {
+      if (size_t elementSize = fixedPayloadSize(elementType); elementSize != 0) {
+        m_Input.skip(length * elementSize);
+      } else {
+        for (size_t i = 0; i < length; i++) skipPayload(m_Input, elementType);
+      }
+      return;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+      readValue(elementType, {});
+    }
+    m_Visitor.onListEnd();
+  }
+
+  void readCompound(std::string_view name) {
+    if (!m_Visitor.onCompoundBegin(name)) {
+      skipPayload(m_Input, Type::COMPOUND);
+      return;
+    }
+
+    Type type = m_Input.readType();
+    while (type != static_cast<Type>(0)) {
+      readValue(type, readName());
+      type = m_Input.readType();
+    }
+    m_Visitor.onCompoundEnd();
+  }
+ private:
+  /**
+   * @return Returns the next length prefixed name. For stream inputs it is valid until the next name is read.
+   */
+  std::string_view readName() {
+    auto length = m_Input.template readPrimitive<uint16_t>();
+    if constexpr (std::is_same_v<Input, BufferInput>) {
+      return {m_Input.consume(length), length};
+    } else {
+      m_Name.resize(length);
+      m_Input.read(m_Name.data(), length);
+      return m_Name;
+    }
+  }
+
+  std::string_view readString() {
+    auto length = m_Input.template readPrimitive<uint16_t>();
+    const char* data = readBytes(length);
+
+    if (utf::asciiPrefix<true>(data, length) == length) return {data, length};
+
+    utf::decodeUTF(data, length, m_String);
+    return m_String;
+  }
+
+  template<typename T>
+  ArrayView<T> readArray() {
+    auto length = m_Input.template readPrimitive<int32_t>();
+    if (length < 0) throw std::runtime_error("negative nbt array length");
+    return {readBytes(static_cast<size_t>(length) * sizeof(T)), static_cast<size_t>(length)};
+  }
+
+  const char* readBytes(size_t length) {
+    if constexpr (std::is_same_v<Input, BufferInput>) {
+      return m_Input.consume(length);
+    } else {
+      // The length is unverified until the data arrives, so the scratch buffer grows by at most 1 MiB per read
+      constexpr size_t STEP = 1 << 20;
+      m_Bytes.clear();
+      for (size_t offset = 0; offset < length; offset += STEP) {
+        size_t count = std::min(length - offset, STEP);
+        m_Bytes.resize(offset + count);
+        m_Input.read(m_Bytes.data() + offset, count);
+      }
+      return m_Bytes.data();
+    }
+  }
+
+  Input& m_Input;
+  Visitor& m_Visitor;
+
+  std::string m_Name;
+  std::string m_String;
+  std::vector<char> m_Bytes;
+};
+
+} // namespace nbt
+
+#endif //NBT_SRC_EVENT_DECODER_HPP_
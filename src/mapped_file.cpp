@@ -0,0 +1,101 @@
+#include "mapped_file.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+  #define WIN32_LEAN_AND_MEAN
+  #define NOMINMAX
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace nbt {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path) : m_Data(nullptr), m_Size(0), m_Handle(nullptr) {
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("failed to open " + path);
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size)) {
+    CloseHandle(file);
+    throw std::runtime_error("failed to stat " + path);
+  }
+  m_Size = static_cast<size_t>(size.QuadPart);
+
+  if (m_Size != 0) {
+    m_Handle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_Handle != nullptr) m_Data = static_cast<const char*>(MapViewOfFile(m_Handle, FILE_MAP_READ, 0, 0, 0));
+  }
+  CloseHandle(file);
+
+  if (m_Size != 0 && m_Data == nullptr) {
+    if (m_Handle != nullptr) CloseHandle(m_Handle);
+    throw std::runtime_error("failed to map " + path);
+  }
+}
+
+void MappedFile::adviseSequential() const {}  // Windows reads mapped files ahead on its own
+
+void MappedFile::unmap() {
+  if (m_Data != nullptr) UnmapViewOfFile(m_Data);
+  if (m_Handle != nullptr) CloseHandle(m_Handle);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) : m_Data(nullptr), m_Size(0), m_Handle(nullptr) {
+  int file = open(path.c_str(), O_RDONLY);
+  if (file < 0) throw std::runtime_error("failed to open " + path);
+
+  struct stat status{};
+  if (fstat(file, &status) != 0) {
+    close(file);
+    throw std::runtime_error("failed to stat " + path);
+  }
+  m_Size = static_cast<size_t>(status.st_size);
+
+  if (m_Size != 0) {
+    void* data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (data == MAP_FAILED) {
+      close(file);
+      throw std::runtime_error("failed to map " + path);
+    }
+    m_Data = static_cast<const char*>(data);
+  }
+  close(file);
+}
+
+void MappedFile::adviseSequential() const {
+  if (m_Data != nullptr) madvise(const_cast<char*>(m_Data), m_Size, MADV_SEQUENTIAL);
+}
+
+void MappedFile::unmap() {
+  if (m_Data != nullptr) munmap(const_cast<char*>(m_Data), m_Size);
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+  unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept : m_Data(std::exchange(other.m_Data, nullptr)), m_Size(std::exchange(other.m_Size, 0)), m_Handle(std::exchange(other.m_Handle, nullptr)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    unmap();
+    m_Data = std::exchange(other.m_Data, nullptr);
+    m_Size = std::exchange(other.m_Size, 0);
+    m_Handle = std::exchange(other.m_Handle, nullptr);
+  }
+  return *this;
+}
+
+} // namespace nbt
@@ -0,0 +1,42 @@
+#ifndef NBT_SRC_MAPPED_FILE_HPP_
+#define NBT_SRC_MAPPED_FILE_HPP_
+
+#include <cstddef>
+#include <string>
+
+namespace nbt {
+
+/**
+ * Read-only memory mapping of a whole file, unmapped on destruction.
+ */
+class MappedFile {
+ public:
+  MappedFile() : m_Data(nullptr), m_Size(0), m_Handle(nullptr) {}
+  explicit MappedFile(const std::string& path);
+  ~MappedFile();
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /**
+   * Hints that the mapping will be read front to back, so that the kernel reads ahead aggressively and drops pages
+   * behind the reader early.
+   */
+  void adviseSequential() const;
+
+  [[nodiscard]] const char* data() const { return m_Data; }
+  [[nodiscard]] size_t size() const { return m_Size; }
+ private:
+  void unmap();
+
+  const char* m_Data;
+  size_t m_Size;
+  void* m_Handle;  // File mapping handle on Windows
+};
+
+} // namespace nbt
+
+#endif //NBT_SRC_MAPPED_FILE_HPP_
@@ -1,142 +1,222 @@
 #ifndef NBT_SRC_MODIFIED_UTF_HPP_
 #define NBT_SRC_MODIFIED_UTF_HPP_
 
-#include <istream>
-#include <ostream>
-
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "ascii_scan.hpp"
+#include "buffer_input.hpp"
 #include "byteswap.hpp"
 #include "primitive.hpp"
 
 namespace nbt::utf {
 
-inline void writeUTF(std::ostream& out, const std::string_view& string) {
-  auto strlen = static_cast<uint16_t>(string.length());
-
-  int utflen = 0;
-  int c, count = 0;
-
-  /* use charAt instead of copying String to char array */
-  for (int i = 0; i < strlen; i++) {
-    c = static_cast<uint8_t>(string[i]);
-    if ((c >= 0x0001) && (c <= 0x007F)) {
-      utflen++;
-    } else if (c > 0x07FF) {
-      utflen += 3;
-    } else {
-      utflen += 2;
+/**
+ * In memory, strings are UTF-8. On the wire they are modified UTF-8: NUL takes two bytes (C0 80) and supplementary
+ * characters are split into surrogate pairs of three bytes each.
+ */
+
+/**
+ * Reads the UTF-8 sequence starting at data[i] and advances i past it. Bytes that do not start a well-formed sequence
+ * are taken on their own, as Latin-1 characters. Surrogate code points pass through, so that unpaired surrogates
+ * survive a round trip.
+ * @return Returns the code point.
+ */
+inline uint32_t nextCodePoint(const char* data, size_t length, size_t& i) {
+  auto lead = static_cast<uint8_t>(data[i]);
+  auto continuation = [&](size_t offset) {
+    return i + offset < length && (static_cast<uint8_t>(data[i + offset]) & 0xC0) == 0x80;
+  };
+  auto bits = [&](size_t offset) { return static_cast<uint32_t>(static_cast<uint8_t>(data[i + offset]) & 0x3F); };
+
+  uint32_t codePoint = lead;
+  size_t size = 1;
+  if (lead >= 0xC2 && lead <= 0xDF && continuation(1)) {
+    codePoint = (lead & 0x1FU) << 6 | bits(1);
+    size = 2;
+  } else if (lead >= 0xE0 && lead <= 0xEF && continuation(1) && continuation(2)) {
+    uint32_t decoded = (lead & 0x0FU) << 12 | bits(1) << 6 | bits(2);
+    if (decoded >= 0x800) {
+      codePoint = decoded;
+      size = 3;
+    }
+  } else if (lead >= 0xF0 && lead <= 0xF4 && continuation(1) && continuation(2) && continuation(3)) {
+    uint32_t decoded = (lead & 0x07U) << 18 | bits(1) << 12 | bits(2) << 6 | bits(3);
+    if (decoded >= 0x10000 && decoded <= 0x10FFFF) {
+      codePoint = decoded;
+      size = 4;
     }
   }
 
-  if (utflen > 65535) throw std::runtime_error("encoded string too long");
-  Primitive<uint16_t>::writeTo(out, utflen);
+  i += size;
+  return codePoint;
+}
 
-  auto bytearr = std::make_unique<char[]>(utflen);
+/**
+ * @return Returns the modified UTF-8 length of a code point.
+ */
+inline size_t encodedLength(uint32_t codePoint) {
+  if (codePoint == 0) return 2;
+  if (codePoint < 0x80) return 1;
+  if (codePoint < 0x800) return 2;
+  if (codePoint < 0x10000) return 3;
+  return 6;
+}
 
-  int i=0;
-  for (i=0; i<strlen; i++) {
-    c = static_cast<uint8_t>(string[i]);
-    if (!((c >= 0x0001) && (c <= 0x007F))) break;
-    bytearr[count++] = static_cast<char>(c);
+inline char* encodeUnit(char* out, uint32_t unit) {
+  if (unit != 0 && unit < 0x80) {
+    *out++ = static_cast<char>(unit);
+  } else if (unit < 0x800) {
+    *out++ = static_cast<char>(0xC0 | (unit >> 6));
+    *out++ = static_cast<char>(0x80 | (unit & 0x3F));
+  } else {
+    *out++ = static_cast<char>(0xE0 | (unit >> 12));
+    *out++ = static_cast<char>(0x80 | ((unit >> 6) & 0x3F));
+    *out++ = static_cast<char>(0x80 | (unit & 0x3F));
   }
+  return out;
+}
 
-  for (;i < strlen; i++){
-    c = static_cast<uint8_t>(string[i]);
-    if ((c >= 0x0001) && (c <= 0x007F)) {
-      bytearr[count++] = static_cast<char>(c);
-
-    } else if (c > 0x07FF) {
-      bytearr[count++] = static_cast<char>((0xE0 | (( c >> 12) & 0x0F)));
-      bytearr[count++] = static_cast<char>((0x80 | ((c >>  6) & 0x3F)));
-      bytearr[count++] = static_cast<char>((0x80 | ((c >>  0) & 0x3F)));
+/**
+ * Encodes string with its length prefix at out, which must have room for getByteLength(string) bytes.
+ * @return Returns the position after the encoded string.
+ */
+inline char* encodeUTF(char* out, const std::string_view& string) {
+  char* begin = out;
+  out += Primitive<uint16_t>::getSize();
+
+  size_t i = asciiPrefix<false>(string.data(), string.length());
+  std::memcpy(out, string.data(), i);
+  out += i;
+
+  while (i < string.length()) {
+    uint32_t codePoint = nextCodePoint(string.data(), string.length(), i);
+    if (codePoint < 0x10000) {
+      out = encodeUnit(out, codePoint);
     } else {
-      bytearr[count++] = static_cast<char>((0xC0 | ((c >>  6) & 0x1F)));
-      bytearr[count++] = static_cast<char>((0x80 | ((c >>  0) & 0x3F)));
+      codePoint -= 0x10000;
+      out = encodeUnit(out, 0xD800 | (codePoint >> 10));
+      out = encodeUnit(out, 0xDC00 | (codePoint & 0x3FF));
     }
   }
-  out.write(bytearr.get(), utflen);
+
+  Primitive<uint16_t>::store(begin, static_cast<uint16_t>(out - begin - Primitive<uint16_t>::getSize()));
+  return out;
 }
 
+/**
+ * @return Returns the encoded length of string, including its length prefix.
+ */
 inline size_t getByteLength(const std::string_view& string) {
-  auto strlen = static_cast<uint16_t>(string.length());
-
-  int utflen = 0;
-  int c, count = 0;
-
-  for (int i = 0; i < strlen; i++) {
-    c = static_cast<uint8_t>(string[i]);
-    if ((c >= 0x0001) && (c <= 0x007F)) {
-      utflen++;
-    } else if (c > 0x07FF) {
-      utflen += 3;
-    } else {
-      utflen += 2;
-    }
+  size_t i = asciiPrefix<false>(string.data(), string.length());
+  size_t utflen = i;
+  while (i < string.length()) {
+    utflen += encodedLength(nextCodePoint(string.data(), string.length(), i));
   }
 
+  if (utflen > 65535) throw std::runtime_error("encoded string too long");
   return utflen + Primitive<uint16_t>::getSize();
 }
 
-inline std::string readUTF(std::istream& in) {
-  uint16_t utflen;
-  in.read(reinterpret_cast<char*>(&utflen), sizeof(utflen));
-  utflen = hostToNetwork16(utflen);
+inline char* appendUTF8(char* out, uint32_t codePoint) {
+  if (codePoint < 0x80) {
+    *out++ = static_cast<char>(codePoint);
+  } else if (codePoint < 0x800) {
+    *out++ = static_cast<char>(0xC0 | (codePoint >> 6));
+    *out++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+  } else if (codePoint < 0x10000) {
+    *out++ = static_cast<char>(0xE0 | (codePoint >> 12));
+    *out++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    *out++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+  } else {
+    *out++ = static_cast<char>(0xF0 | (codePoint >> 18));
+    *out++ = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+    *out++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    *out++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+  }
+  return out;
+}
 
-  auto allocation = std::make_unique<char[]>(utflen * 2 + 1);
+/**
+ * Decodes utflen bytes of modified UTF-8 into UTF-8 at output, which may be buffer itself: the output never outgrows
+ * the input read so far.
+ * @return Returns the decoded length.
+ */
+inline size_t decodeUTF(const char* buffer, size_t utflen, char* output) {
+  size_t count = asciiPrefix<true>(buffer, utflen);
+  if (output != buffer) std::memcpy(output, buffer, count);
+  char* out = output + count;
+
+  auto unit = [&](size_t offset) -> uint32_t {
+    auto c = static_cast<uint8_t>(buffer[offset]);
+    if ((c >> 5) == 6) {
+      if (offset + 2 > utflen) throw std::runtime_error("malformed input: partial character at end");
+      auto char2 = static_cast<uint8_t>(buffer[offset + 1]);
+      if ((char2 & 0xC0) != 0x80) throw std::runtime_error("malformed input around byte " + std::to_string(offset + 1));
+      return (c & 0x1FU) << 6 | (char2 & 0x3FU);
+    }
+    if ((c >> 4) == 14) {
+      if (offset + 3 > utflen) throw std::runtime_error("malformed input: partial character at end");
+      auto char2 = static_cast<uint8_t>(buffer[offset + 1]);
+      auto char3 = static_cast<uint8_t>(buffer[offset + 2]);
+      if ((char2 & 0xC0) != 0x80 || (char3 & 0xC0) != 0x80) throw std::runtime_error("malformed input around byte " + std::to_string(offset + 2));
+      return (c & 0x0FU) << 12 | (char2 & 0x3FU) << 6 | (char3 & 0x3FU);
+    }
+    throw std::runtime_error("malformed input around byte " + std::to_string(offset));
+  };
 
-  char* buffer = allocation.get();
-  char* output = allocation.get() + utflen;
+  while (count < utflen) {
+    auto c = static_cast<uint8_t>(buffer[count]);
+    if (c < 0x80) {
+      *out++ = static_cast<char>(c);
+      count++;
+      continue;
+    }
 
-  in.read(buffer, utflen);
+    uint32_t codePoint = unit(count);
+    count += c < 0xE0 ? 2 : 3;
 
-  int c, char2, char3;
-  int count = 0;
-  int chararr_count = 0;
+    if (codePoint >= 0xD800 && codePoint <= 0xDBFF && count + 3 <= utflen && static_cast<uint8_t>(buffer[count]) == 0xED) {
+      uint32_t low = unit(count);
+      if (low >= 0xDC00 && low <= 0xDFFF) {
+        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+        count += 3;
+      }
+    }
+    out = appendUTF8(out, codePoint);
+  }
 
-  while (count < utflen) {
-    c = (int) buffer[count] & 0xff;
-    if (c > 127) break;
-    count++;
-    output[chararr_count++] = (char) c;
+  return static_cast<size_t>(out - output);
+}
+
+template<typename StringType>
+inline void decodeUTF(const char* buffer, uint16_t utflen, StringType& result) {
+  if (asciiPrefix<true>(buffer, utflen) == utflen) {
+    result.assign(buffer, utflen);
+    return;
   }
 
-  while (count < utflen) {
-    c = (int) buffer[count] & 0xff;
-    switch (c >> 4) {
-      case 0:
-      case 1:
-      case 2:
-      case 3:
-      case 4:
-      case 5:
-      case 6:
-      case 7:count++;
-        output[chararr_count++] = (char) c;
-        break;
-      case 12:
-      case 13:count += 2;
-        if (count > utflen)
-          throw std::runtime_error("malformed input: partial character at end");
-        char2 = (int) static_cast<uint8_t>(buffer[count - 1]);
-        if ((char2 & 0xC0) != 0x80)
-          throw std::runtime_error("malformed input around byte " + std::to_string(count));
-        output[chararr_count++] = (char) (((c & 0x1F) << 6) |
-            (char2 & 0x3F));
-        break;
-      case 14:count += 3;
-        if (count > utflen)
-          throw std::runtime_error("malformed input: partial character at end");
-        char2 = (int) static_cast<uint8_t>(buffer[count - 2]);
-        char3 = (int) static_cast<uint8_t>(buffer[count - 1]);
-        if (((char2 & 0xC0) != 0x80) || ((char3 & 0xC0) != 0x80)) throw std::runtime_error("malformed input around byte " + std::to_string(count - 1));
-        output[chararr_count++] = (char) (((c & 0x0F) << 12) |
-            ((char2 & 0x3F) << 6) |
-            ((char3 & 0x3F) << 0));
-        break;
-      default:throw std::runtime_error("malformed input around byte " + std::to_string(count));
-    }
+  result.resize(utflen);
+  result.resize(decodeUTF(buffer, utflen, result.data()));
+}
+
+template<typename Input>
+inline String readUTF(Input& in, std::pmr::memory_resource* resource) {
+  uint16_t utflen = Primitive<uint16_t>::readFrom(in);
+  if constexpr (HasConsume<Input>::value) {
+    String string(resource);
+    decodeUTF(in.consume(utflen), utflen, string);
+    return string;
   }
 
-  return {output, static_cast<size_t>(chararr_count)};
+  String string(resource);
+  string.resize(utflen);
+  in.read(string.data(), utflen);
+  string.resize(decodeUTF(string.data(), utflen, string.data()));  // Decodes in place
+  return string;
 }
 
 } // namespace nbt
@@ -0,0 +1,111 @@
+#include "nbt/nbt_batch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <utility>
+
+namespace nbt {
+
+/**
+ * Upstream of a thread's arena, which records how much memory the arena needed beyond its buffer.
+ */
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  size_t allocated = 0;
+ private:
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    allocated += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {
+    std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+  }
+
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+struct BatchReader::Slot {
+  std::vector<char> buffer;  // Arena memory, grown after batches that overflowed it
+  CountingResource upstream;
+  std::optional<std::pmr::monotonic_buffer_resource> arena;
+  std::vector<std::pair<size_t, Compound>> results;
+  size_t bytes = 0;
+
+  /**
+   * Releases the previous batch's documents and sizes the buffer to what that batch needed.
+   */
+  void reset() {
+    results.clear();
+    arena.reset();
+    if (upstream.allocated != 0) buffer.resize(buffer.size() + upstream.allocated);
+    upstream.allocated = 0;
+    bytes = 0;
+    arena.emplace(buffer.data(), buffer.size(), &upstream);
+  }
+};
+
+constexpr size_t INITIAL_ARENA_SIZE = 64 * 1024;
+
+BatchReader::BatchReader(ThreadPool& pool) : m_Pool(pool) {
+  for (size_t i = 0; i < pool.getConcurrency(); i++) {
+    m_Slots.push_back(std::make_unique<Slot>());
+    m_Slots.back()->buffer.resize(INITIAL_ARENA_SIZE);
+  }
+}
+
+BatchReader::~BatchReader() = default;  // Destroys the documents before the arenas they live in
+
+const std::vector<Compound>& BatchReader::parse(const std::vector<std::string_view>& documents, const ReaderOptions& options) {
+  auto start = std::chrono::steady_clock::now();
+  m_Documents.clear();
+  for (auto& slot : m_Slots) slot->reset();
+
+  // Every slot is one task with its own arena. The tasks claim small groups of documents from a shared cursor, so
+  // threads that finish early take over the rest of the batch.
+  size_t grain = std::clamp<size_t>(documents.size() / (m_Slots.size() * 16), 1, 64);
+  std::atomic<size_t> next{0};
+  m_Pool.run(m_Slots.size(), [&](size_t index) {
+    Slot& slot = *m_Slots[index];
+    ReaderOptions local = options;
+    local.resource = &*slot.arena;
+    local.pool = nullptr;  // The arena is not thread safe, and the batch is already parallel across documents
+
+    for (size_t begin = next.fetch_add(grain); begin < documents.size(); begin = next.fetch_add(grain)) {
+      for (size_t i = begin; i < std::min(begin + grain, documents.size()); i++) {
+        slot.results.emplace_back(i, Reader::parse(documents[i].data(), documents[i].size(), local));
+        slot.bytes += documents[i].size();
+      }
+    }
+  });
+
+  // Move construction keeps each document's arena, unlike assignment.
+  std::vector<Compound*> ordered(documents.size());
+  m_Stats = BatchStats();
+  for (auto& slot : m_Slots) {
+    for (auto& result : slot->results) ordered[result.first] = &result.second;
+    m_Stats.bytes += slot->bytes;
+    m_Stats.arenas += slot->results.empty() ? 0 : 1;
+  }
+
+  m_Documents.reserve(documents.size());
+  for (Compound* document : ordered) m_Documents.push_back(std::move(*document));
+
+  m_Stats.documents = documents.size();
+  m_Stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return m_Documents;
+}
+
+const std::vector<Compound>& BatchReader::getDocuments() const {
+  return m_Documents;
+}
+
+const BatchStats& BatchReader::getStats() const {
+  return m_Stats;
+}
+
+} // namespace nbt
@@ -0,0 +1,391 @@
+#include "nbt/nbt_diff.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "buffer_input.hpp"
+#include "codec.hpp"
+#include "decoder.hpp"
+#include "encoder.hpp"
+
+namespace nbt {
+
+/**
+ * Unchanged bytes between two changed ranges of an array, up to which both are patched by one splice.
+ */
+constexpr size_t MERGE_GAP = 16;
+
+void Patch::add(Edit edit) {
+  m_Edits.push_back(std::move(edit));
+}
+
+const std::vector<Patch::Edit>& Patch::getEdits() const {
+  return m_Edits;
+}
+
+bool Patch::empty() const {
+  return m_Edits.empty();
+}
+
+namespace {
+
+size_t getPathSize(const std::vector<Patch::Segment>& path) {
+  size_t size = getVarintSize(path.size());
+  for (const auto& segment : path) {
+    if (segment.isKey()) {
+      size += getVarintSize(static_cast<uint64_t>(segment.key.size()) << 1) + segment.key.size();
+    } else {
+      size += getVarintSize((static_cast<uint64_t>(segment.index) << 1) | 1);
+    }
+  }
+  return size;
+}
+
+} // namespace
+
+std::vector<char> Patch::encode() const {
+  size_t size = getVarintSize(m_Edits.size());
+  for (const auto& edit : m_Edits) {
+    size += 1 + getPathSize(edit.path);
+    if (edit.operation == Operation::SPLICE) size += getVarintSize(edit.offset) + getVarintSize(edit.count);
+    if (edit.operation != Operation::REMOVE) size += 1 + Encoder<JavaCodec>::getSize(edit.value);
+  }
+
+  std::vector<char> buffer(size);
+  char* out = storeVarint(buffer.data(), m_Edits.size());
+  for (const auto& edit : m_Edits) {
+    *out++ = static_cast<char>(edit.operation);
+    out = storeVarint(out, edit.path.size());
+    for (const auto& segment : edit.path) {
+      if (segment.isKey()) {
+        out = storeVarint(out, static_cast<uint64_t>(segment.key.size()) << 1);
+        if (!segment.key.empty()) std::memcpy(out, segment.key.data(), segment.key.size());
+        out += segment.key.size();
+      } else {
+        out = storeVarint(out, (static_cast<uint64_t>(segment.index) << 1) | 1);
+      }
+    }
+    if (edit.operation == Operation::SPLICE) {
+      out = storeVarint(out, edit.offset);
+      out = storeVarint(out, edit.count);
+    }
+    if (edit.operation != Operation::REMOVE) {
+      Encoder<JavaCodec> encoder(out);
+      encoder.writeType(edit.value.getType());
+      encoder.writeValue(edit.value);
+      out = encoder.position();
+    }
+  }
+  return buffer;
+}
+
+Patch Patch::decode(const void* data, size_t length, const ReaderLimits& limits) {
+  const char* begin = reinterpret_cast<const char*>(data);
+  BufferInput in(begin, begin + length);
+  Decoder<BufferInput> decoder(in, std::pmr::get_default_resource());
+  if (!limits.isUnlimited()) decoder.setLimits(limits);
+
+  Patch patch;
+  uint64_t edits = readVarint(in, 10);
+  for (uint64_t i = 0; i < edits; i++) {
+    Edit edit{};
+    edit.operation = static_cast<Operation>(in.readPrimitive<uint8_t>());
+    if (edit.operation > Operation::SPLICE) throw std::runtime_error("invalid nbt patch operation");
+
+    uint64_t segments = readVarint(in, 10);
+    for (uint64_t j = 0; j < segments; j++) {
+      uint64_t segment = readVarint(in, 10);
+      if ((segment & 1) != 0) {
+        edit.path.push_back({{}, static_cast<size_t>(segment >> 1)});
+      } else {
+        const char* key = in.consume(segment >> 1);
+        edit.path.push_back({std::string(key, segment >> 1), Segment::KEY});
+      }
+    }
+    if (edit.operation == Operation::SPLICE) {
+      edit.offset = readVarint(in, 10);
+      edit.count = readVarint(in, 10);
+    }
+    if (edit.operation != Operation::REMOVE) edit.value = decoder.readValue(in.readType());
+    patch.add(std::move(edit));
+  }
+
+  if (in.remaining() != 0) throw std::runtime_error("trailing data after nbt patch");
+  return patch;
+}
+
+namespace {
+
+/**
+ * @return Returns the unboxed elements of a list of T.
+ */
+template<typename T, typename L>
+auto& elementsOf(L& list) {
+  if constexpr (std::is_same_v<T, int8_t>) return list.getBytes();
+  else if constexpr (std::is_same_v<T, int16_t>) return list.getShorts();
+  else if constexpr (std::is_same_v<T, int32_t>) return list.getInts();
+  else if constexpr (std::is_same_v<T, int64_t>) return list.getLongs();
+  else if constexpr (std::is_same_v<T, float>) return list.getFloats();
+  else return list.getDoubles();
+}
+
+/**
+ * Compares bit patterns, so that changes between 0.0 and -0.0 are kept and equal NaNs are not patched again.
+ */
+template<typename T>
+bool isSame(const T& a, const T& b) {
+  return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+/**
+ * @return Returns elements [begin, end) as an array, or as a list of listType unless listType is TAG_End.
+ */
+template<typename T>
+Value slice(const std::pmr::vector<T>& values, size_t begin, size_t end, Type listType) {
+  if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t>) {
+    if (listType == static_cast<Type>(0)) return Value(std::pmr::vector<T>(values.begin() + begin, values.begin() + end));
+  }
+
+  List list(listType);
+  elementsOf<T>(list).assign(values.begin() + begin, values.begin() + end);
+  return list;
+}
+
+void addSet(const std::vector<Patch::Segment>& path, const Value& value, Patch& patch) {
+  patch.add({Patch::Operation::SET, path, value});
+}
+
+void addSplice(const std::vector<Patch::Segment>& path, size_t offset, size_t count, Value elements, Patch& patch) {
+  patch.add({Patch::Operation::SPLICE, path, std::move(elements), offset, count});
+}
+
+/**
+ * Patches the elements of an array, or of a list of primitives, that changed between a and b, which is target's
+ * payload. Runs separated by up to MERGE_GAP unchanged bytes are merged, and target is set whole if most elements
+ * changed.
+ */
+template<typename T>
+void diffElements(const std::pmr::vector<T>& a, const std::pmr::vector<T>& b, Type listType, const Value& target, std::vector<Patch::Segment>& path, Patch& patch) {
+  if (a.size() != b.size()) {
+    size_t common = std::min(a.size(), b.size());
+    size_t prefix = 0;
+    while (prefix < common && isSame(a[prefix], b[prefix])) prefix++;
+    size_t suffix = 0;
+    while (suffix < common - prefix && isSame(a[a.size() - 1 - suffix], b[b.size() - 1 - suffix])) suffix++;
+
+    if ((b.size() - prefix - suffix) * 2 > b.size()) return addSet(path, target, patch);
+    return addSplice(path, prefix, a.size() - prefix - suffix, slice(b, prefix, b.size() - suffix, listType), patch);
+  }
+
+  std::vector<std::pair<size_t, size_t>> ranges;
+  size_t changed = 0;
+  for (size_t i = 0; i < b.size();) {
+    if (isSame(a[i], b[i])) {
+      i++;
+      continue;
+    }
+
+    size_t end = i + 1;
+    while (end < b.size()) {
+      if (!isSame(a[end], b[end])) {
+        end++;
+        continue;
+      }
+      size_t gap = end;
+      while (gap < b.size() && isSame(a[gap], b[gap]) && (gap - end + 1) * sizeof(T) <= MERGE_GAP) gap++;
+      if (gap == b.size() || isSame(a[gap], b[gap])) break;
+      end = gap;
+    }
+    ranges.emplace_back(i, end);
+    changed += end - i;
+    i = end;
+  }
+
+  if (changed * 2 > b.size()) return addSet(path, target, patch);
+  for (const auto& [begin, end] : ranges) addSplice(path, begin, end - begin, slice(b, begin, end, listType), patch);
+}
+
+void diffValue(const Value& a, const Value& b, std::vector<Patch::Segment>& path, Patch& patch);
+
+void diffCompound(const Compound& a, const Compound& b, std::vector<Patch::Segment>& path, Patch& patch) {
+  for (const auto& [key, value] : a) {
+    if (value.getType() == static_cast<Type>(0)) continue;  // NULL-Pair
+    const Value* other = b.get(key);
+    if (other != nullptr && other->getType() != static_cast<Type>(0)) continue;
+
+    path.push_back({std::string(key.view()), Patch::Segment::KEY});
+    patch.add({Patch::Operation::REMOVE, path, Value()});
+    path.pop_back();
+  }
+
+  for (const auto& [key, value] : b) {
+    if (value.getType() == static_cast<Type>(0)) continue;
+    const Value* old = a.get(key);
+
+    path.push_back({std::string(key.view()), Patch::Segment::KEY});
+    if (old == nullptr || old->getType() == static_cast<Type>(0)) {
+      addSet(path, value, patch);
+    } else {
+      diffValue(*old, value, path, patch);
+    }
+    path.pop_back();
+  }
+}
+
+void diffList(const Value& a, const Value& b, std::vector<Patch::Segment>& path, Patch& patch) {
+  const List& x = a.getList();
+  const List& y = b.getList();
+  if (x.getType() != y.getType()) return addSet(path, b, patch);
+
+  if (x.hasTypedStorage() && y.hasTypedStorage()) {
+    switch (x.getType()) {
+      case Type::BYTE: return diffElements(x.getBytes(), y.getBytes(), Type::BYTE, b, path, patch);
+      case Type::SHORT: return diffElements(x.getShorts(), y.getShorts(), Type::SHORT, b, path, patch);
+      case Type::INT: return diffElements(x.getInts(), y.getInts(), Type::INT, b, path, patch);
+      case Type::LONG: return diffElements(x.getLongs(), y.getLongs(), Type::LONG, b, path, patch);
+      case Type::FLOAT: return diffElements(x.getFloats(), y.getFloats(), Type::FLOAT, b, path, patch);
+      case Type::DOUBLE: return diffElements(x.getDoubles(), y.getDoubles(), Type::DOUBLE, b, path, patch);
+      default: break;
+    }
+  }
+
+  size_t common = std::min(x.size(), y.size());
+  for (size_t i = 0; i < common; i++) {
+    path.push_back({{}, i});
+    diffValue(x[i], y[i], path, patch);
+    path.pop_back();
+  }
+  if (x.size() == y.size()) return;
+
+  List tail(y.getType());
+  for (size_t i = common; i < y.size(); i++) tail.pushBack(y[i]);
+  addSplice(path, common, x.size() - common, std::move(tail), patch);
+}
+
+void diffValue(const Value& a, const Value& b, std::vector<Patch::Segment>& path, Patch& patch) {
+  if (a.getType() != b.getType()) return addSet(path, b, patch);
+
+  // Payloads shared through Value::share() are the same object, and need not be compared
+  switch (a.getType()) {
+    case Type::COMPOUND:
+      if (&a.getCompound() != &b.getCompound()) diffCompound(a.getCompound(), b.getCompound(), path, patch);
+      return;
+    case Type::LIST:
+      if (&a.getList() != &b.getList()) diffList(a, b, path, patch);
+      return;
+    case Type::BYTE_ARRAY:
+      if (&a.getByteArray() != &b.getByteArray()) diffElements(a.getByteArray(), b.getByteArray(), static_cast<Type>(0), b, path, patch);
+      return;
+    case Type::INT_ARRAY:
+      if (&a.getIntArray() != &b.getIntArray()) diffElements(a.getIntArray(), b.getIntArray(), static_cast<Type>(0), b, path, patch);
+      return;
+    case Type::LONG_ARRAY:
+      if (&a.getLongArray() != &b.getLongArray()) diffElements(a.getLongArray(), b.getLongArray(), static_cast<Type>(0), b, path, patch);
+      return;
+    case Type::FLOAT:
+      if (!isSame(a.getFloat(), b.getFloat())) addSet(path, b, patch);
+      return;
+    case Type::DOUBLE:
+      if (!isSame(a.getDouble(), b.getDouble())) addSet(path, b, patch);
+      return;
+    default:
+      if (!(a == b)) addSet(path, b, patch);
+  }
+}
+
+} // namespace
+
+Patch diff(const Compound& a, const Compound& b) {
+  Patch patch;
+  std::vector<Patch::Segment> path;
+  if (&a != &b) diffCompound(a, b, path, patch);
+  return patch;
+}
+
+namespace {
+
+/**
+ * @return Returns the tag at the first length segments of path, which must be a compound or list unless it is the
+ * last one.
+ */
+Value& resolve(Compound& root, const std::vector<Patch::Segment>& path, size_t length) {
+  Compound* compound = &root;
+  List* list = nullptr;
+  Value* value = nullptr;
+  for (size_t i = 0; i < length; i++) {
+    const auto& segment = path[i];
+    if (segment.isKey()) {
+      value = compound != nullptr ? compound->get(segment.key) : nullptr;
+    } else {
+      value = list != nullptr && segment.index < list->size() ? &(*list)[segment.index] : nullptr;
+    }
+    if (value == nullptr) throw std::runtime_error("nbt patch path does not match the compound");
+
+    if (i + 1 == length) break;
+    compound = value->getType() == Type::COMPOUND ? &value->getCompound() : nullptr;
+    list = value->getType() == Type::LIST ? &value->getList() : nullptr;
+  }
+  if (value == nullptr) throw std::runtime_error("nbt patch path is empty");
+  return *value;
+}
+
+/**
+ * Replaces count elements of values, from offset on, with inserted.
+ */
+template<typename T>
+void spliceElements(std::pmr::vector<T>& values, size_t offset, size_t count, const std::pmr::vector<T>& inserted) {
+  if (offset > values.size() || count > values.size() - offset) throw std::runtime_error("nbt patch splice out of range");
+  auto position = values.erase(values.begin() + offset, values.begin() + offset + count);
+  values.insert(position, inserted.begin(), inserted.end());
+}
+
+void applySplice(Value& target, const Patch::Edit& edit) {
+  if (target.getType() != edit.value.getType()) throw std::runtime_error("nbt patch splice does not match the tag type");
+  switch (target.getType()) {
+    case Type::BYTE_ARRAY: return spliceElements(target.getByteArray(), edit.offset, edit.count, edit.value.getByteArray());
+    case Type::INT_ARRAY: return spliceElements(target.getIntArray(), edit.offset, edit.count, edit.value.getIntArray());
+    case Type::LONG_ARRAY: return spliceElements(target.getLongArray(), edit.offset, edit.count, edit.value.getLongArray());
+    case Type::LIST: return target.getList().splice(edit.offset, edit.count, edit.value.getList());
+    default: throw std::runtime_error("nbt patch splices a tag without elements");
+  }
+}
+
+} // namespace
+
+void apply(Compound& compound, const Patch& patch) {
+  for (const auto& edit : patch.getEdits()) {
+    if (edit.operation == Patch::Operation::SPLICE) {
+      applySplice(resolve(compound, edit.path, edit.path.size()), edit);
+      continue;
+    }
+    if (edit.path.empty()) throw std::runtime_error("nbt patch path is empty");
+
+    const auto& last = edit.path.back();
+    Compound* parent = &compound;
+    List* list = nullptr;
+    if (edit.path.size() > 1) {
+      Value& value = resolve(compound, edit.path, edit.path.size() - 1);
+      parent = value.getType() == Type::COMPOUND ? &value.getCompound() : nullptr;
+      list = value.getType() == Type::LIST ? &value.getList() : nullptr;
+    }
+
+    if (!last.isKey()) {
+      if (edit.operation != Patch::Operation::SET || list == nullptr || last.index >= list->size()) {
+        throw std::runtime_error("nbt patch path does not match the compound");
+      }
+      if (edit.value.getType() != list->getType()) throw std::runtime_error("element type does not match list type");
+      (*list)[last.index] = edit.value.share();
+    } else if (parent == nullptr) {
+      throw std::runtime_error("nbt patch path does not match the compound");
+    } else if (edit.operation == Patch::Operation::SET) {
+      (*parent)[last.key] = edit.value.share();  // The patch keeps its copy
+    } else if (!parent->remove(last.key)) {
+      throw std::runtime_error("nbt patch removes a missing tag");
+    }
+  }
+}
+
+} // namespace nbt
@@ -0,0 +1,182 @@
+#include "nbt/nbt_index.hpp"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "buffer_input.hpp"
+#include "nbt/nbt.hpp"
+#include "nbt/nbt_path.hpp"
+
+namespace nbt {
+
+/**
+ * Builds the entry table in one pass. The children of the container being scanned collect on a scratch stack and are
+ * moved into the table once the container ends, so that siblings are stored contiguously.
+ */
+class IndexBuilder {
+ public:
+  IndexBuilder(const char* data, std::vector<OffsetIndex::Entry>& entries) : m_Data(data), m_Entries(entries) {}
+
+  void indexDocument(BufferInput& in) {
+    OffsetIndex::Entry document{0, 0, 0, 0, 0, 0, Type::COMPOUND};
+    while (true) {
+      int peek = in.peek();
+      if (peek == EOF || peek == 0) break;
+      indexNamed(in, in.readType());
+    }
+    document.size = offset(in.position());
+    flush(document, 0);
+    m_Entries.push_back(document);
+  }
+ private:
+  void indexNamed(BufferInput& in, Type type) {
+    auto nameLength = in.readPrimitive<uint16_t>();
+    uint32_t name = offset(in.consume(nameLength));
+    indexValue(in, type, name, nameLength);
+  }
+
+  /**
+   * Scans the payload at the input's position and pushes its entry onto the scratch stack.
+   */
+  void indexValue(BufferInput& in, Type type, uint32_t name, uint16_t nameLength) {
+    OffsetIndex::Entry entry{name, offset(in.position()), 0, 0, 0, nameLength, type};
+    size_t base = m_Pending.size();
+
+    if (type == Type::COMPOUND) {
+      Type childType = in.readType();
+      while (childType != static_cast<Type>(0)) {
+        indexNamed(in, childType);
+        childType = in.readType();
+      }
+    } else if (type == Type::LIST) {
+      Type elementType = in.readType();
+      auto arrayLength = in.readPrimitive<int32_t>();
+      uint32_t length = elementType == static_cast<Type>(0) || arrayLength < 0 ? 0 : static_cast<uint32_t>(arrayLength);
+
+      if (size_t elementSize = fixedPayloadSize(elementType); elementSize != 0) {
+        in.skip(length * elementSize);
+        entry.children = OffsetIndex::FIXED_ELEMENTS;
+        entry.count = length;
+      } else {
+        for (uint32_t i = 0; i < length; i++) indexValue(in, elementType, 0, 0);
+      }
+    } else {
+      skipPayload(in, type);
+    }
+
+    entry.size = offset(in.position()) - entry.payload;
+    if (entry.children != OffsetIndex::FIXED_ELEMENTS) flush(entry, base);
+    m_Pending.push_back(entry);
+  }
+
+  void flush(OffsetIndex::Entry& entry, size_t base) {
+    entry.children = static_cast<uint32_t>(m_Entries.size());
+    entry.count = static_cast<uint32_t>(m_Pending.size() - base);
+    m_Entries.insert(m_Entries.end(), m_Pending.begin() + static_cast<std::ptrdiff_t>(base), m_Pending.end());
+    m_Pending.resize(base);
+  }
+
+  uint32_t offset(const char* position) const {
+    return static_cast<uint32_t>(position - m_Data);
+  }
+
+  const char* m_Data;
+  std::vector<OffsetIndex::Entry>& m_Entries;
+  std::vector<OffsetIndex::Entry> m_Pending;
+};
+
+OffsetIndex::OffsetIndex(const void* data, size_t length) : m_Data(reinterpret_cast<const char*>(data)), m_Root(0) {
+  if (length > std::numeric_limits<uint32_t>::max()) throw std::runtime_error("nbt buffer too large to index");
+
+  BufferInput in(m_Data, m_Data + length);
+  IndexBuilder(m_Data, m_Entries).indexDocument(in);
+  m_Root = static_cast<uint32_t>(m_Entries.size() - 1);
+
+  if constexpr (nbt::config::omitRootTag()) { //NOLINT
+    const Entry& document = m_Entries[m_Root];
+    if (document.count == 1) {
+      const Entry& root = m_Entries[document.children];
+      if (root.nameLength == 0 && root.type == Type::COMPOUND) m_Root = document.children;
+    }
+  }
+}
+
+OffsetIndex::Node OffsetIndex::getRoot() const {
+  if (m_Entries.empty()) return {};
+  return {this, m_Root, Node::NO_ELEMENT};
+}
+
+OffsetIndex::Node OffsetIndex::find(std::string_view path) const {
+  Node node = getRoot();
+  for (const auto& segment : PathSet::parse(path)) {
+    if (segment.index == PathSet::Node::ALL) throw std::runtime_error("nbt index paths select single list elements");
+    node = segment.index == PathSet::Node::KEY ? node[segment.name] : node[static_cast<size_t>(segment.index)];
+  }
+  return node;
+}
+
+const std::vector<OffsetIndex::Entry>& OffsetIndex::getEntries() const {
+  return m_Entries;
+}
+
+Type OffsetIndex::Node::getType() const {
+  if (!m_Index) return static_cast<Type>(0);
+  const Entry& entry = m_Index->m_Entries[m_Entry];
+  if (m_Element != NO_ELEMENT) return static_cast<Type>(m_Index->m_Data[entry.payload]);
+  return entry.type;
+}
+
+std::string_view OffsetIndex::Node::getName() const {
+  if (!m_Index || m_Element != NO_ELEMENT) return {};
+  const Entry& entry = m_Index->m_Entries[m_Entry];
+  return {m_Index->m_Data + entry.name, entry.nameLength};
+}
+
+View OffsetIndex::Node::getView() const {
+  if (!m_Index) return {};
+  const Entry& entry = m_Index->m_Entries[m_Entry];
+  const char* payload = m_Index->m_Data + entry.payload;
+
+  if (m_Element != NO_ELEMENT) {
+    auto type = static_cast<Type>(*payload);
+    size_t elementSize = fixedPayloadSize(type);
+    const char* element = payload + 5 + m_Element * elementSize;
+    return {type, element, element + elementSize};
+  }
+
+  return {entry.type, payload, payload + entry.size};
+}
+
+OffsetIndex::Node OffsetIndex::Node::operator[](std::string_view key) const {
+  if (!m_Index || m_Element != NO_ELEMENT) return {};
+
+  const Entry& entry = m_Index->m_Entries[m_Entry];
+  if (entry.type != Type::COMPOUND) return {};
+
+  for (uint32_t i = entry.children; i < entry.children + entry.count; i++) {
+    const Entry& child = m_Index->m_Entries[i];
+    if (child.nameLength == key.size() && std::memcmp(m_Index->m_Data + child.name, key.data(), key.size()) == 0) {
+      return {m_Index, i, NO_ELEMENT};
+    }
+  }
+  return {};
+}
+
+OffsetIndex::Node OffsetIndex::Node::operator[](size_t index) const {
+  if (!m_Index || m_Element != NO_ELEMENT) return {};
+
+  const Entry& entry = m_Index->m_Entries[m_Entry];
+  if (entry.type != Type::LIST || index >= entry.count) return {};
+
+  if (entry.children == FIXED_ELEMENTS) return {m_Index, m_Entry, static_cast<uint32_t>(index)};
+  return {m_Index, static_cast<uint32_t>(entry.children + index), NO_ELEMENT};
+}
+
+size_t OffsetIndex::Node::size() const {
+  if (!m_Index || m_Element != NO_ELEMENT) return 0;
+  return m_Index->m_Entries[m_Entry].count;
+}
+
+} // namespace nbt
@@ -0,0 +1,141 @@
+#include "nbt/nbt_key.hpp"
+
+#include <new>
+
+namespace nbt {
+
+Key::Key(std::string_view key, std::pmr::memory_resource* resource) : m_Inline(), m_Hash(hashOf(key)), m_Length(0) {
+  if (key.size() <= INLINE_CAPACITY) {
+    if (!key.empty()) std::memcpy(m_Inline, key.data(), key.size());  // Empty views may hold a null pointer
+    m_Length = static_cast<uint8_t>(key.size());
+  } else {
+    m_Atom = createAtom(key, m_Hash, resource);
+    m_Length = ATOM;
+  }
+}
+
+Key::Key(const Atom* atom) noexcept : m_Atom(atom), m_Hash(atom->hash), m_Length(ATOM) {
+  retain(atom);
+}
+
+Key& Key::operator=(const Key& rhs) noexcept {
+  if (this == &rhs) return *this;
+  if (rhs.m_Length == ATOM) retain(rhs.m_Atom);
+  if (m_Length == ATOM) release(m_Atom);
+
+  std::memcpy(m_Inline, rhs.m_Inline, INLINE_CAPACITY);
+  m_Hash = rhs.m_Hash;
+  m_Length = rhs.m_Length;
+  return *this;
+}
+
+Key& Key::operator=(Key&& rhs) noexcept {
+  if (this == &rhs) return *this;
+  if (m_Length == ATOM) release(m_Atom);
+
+  std::memcpy(m_Inline, rhs.m_Inline, INLINE_CAPACITY);
+  m_Hash = rhs.m_Hash;
+  m_Length = rhs.m_Length;
+  if (m_Length == ATOM) rhs.clear();
+  return *this;
+}
+
+Key::Atom* Key::createAtom(std::string_view key, uint32_t hash, std::pmr::memory_resource* resource) {
+  void* memory = resource->allocate(sizeof(Atom) + key.size(), alignof(Atom));
+  auto* atom = new(memory) Atom{{1}, static_cast<uint32_t>(key.size()), hash, false, resource};
+  std::memcpy(reinterpret_cast<char*>(atom + 1), key.data(), key.size());
+  return atom;
+}
+
+void Key::destroy(const Atom* atom) {
+  auto* mutableAtom = const_cast<Atom*>(atom);
+  std::pmr::memory_resource* resource = mutableAtom->resource;
+  size_t size = sizeof(Atom) + mutableAtom->length;
+  mutableAtom->~Atom();
+  resource->deallocate(mutableAtom, size, alignof(Atom));
+}
+
+struct KeyTable::Slots {
+  explicit Slots(size_t capacity) : mask(capacity - 1), entries(new std::atomic<const Key::Atom*>[capacity]) {
+    for (size_t i = 0; i < capacity; i++) entries[i].store(nullptr, std::memory_order_relaxed);
+  }
+
+  size_t mask;
+  std::unique_ptr<std::atomic<const Key::Atom*>[]> entries;
+};
+
+KeyTable::KeyTable(bool synchronized, std::pmr::memory_resource* resource) : m_Slots(nullptr), m_Size(0), m_Synchronized(synchronized), m_Resource(resource) {
+  m_Generations.emplace_back(std::make_unique<Slots>(64));
+  m_Slots.store(m_Generations.back().get(), std::memory_order_release);
+}
+
+KeyTable::~KeyTable() {
+  const Slots& slots = *m_Slots.load(std::memory_order_relaxed);
+  for (size_t i = 0; i <= slots.mask; i++) {
+    const Key::Atom* atom = slots.entries[i].load(std::memory_order_relaxed);
+    if (atom == nullptr) continue;
+    m_Resource->deallocate(const_cast<Key::Atom*>(atom), sizeof(Key::Atom) + atom->length, alignof(Key::Atom));
+  }
+}
+
+Key KeyTable::intern(std::string_view key) {
+  uint32_t hash = Key::hashOf(key);
+  const Key::Atom* atom = find(*m_Slots.load(std::memory_order_acquire), key, hash);
+  if (atom != nullptr) return Key(atom);
+
+  if (!m_Synchronized) return Key(insert(key, hash));
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  atom = find(*m_Slots.load(std::memory_order_relaxed), key, hash);  // Another thread may have inserted it meanwhile
+  return Key(atom != nullptr ? atom : insert(key, hash));
+}
+
+const Key::Atom* KeyTable::find(const Slots& slots, std::string_view key, uint32_t hash) const {
+  for (size_t slot = hash & slots.mask;; slot = (slot + 1) & slots.mask) {
+    const Key::Atom* atom = slots.entries[slot].load(std::memory_order_acquire);
+    if (atom == nullptr) return nullptr;
+    if (atom->hash == hash && std::string_view(atom->data(), atom->length) == key) return atom;
+  }
+}
+
+const Key::Atom* KeyTable::insert(std::string_view key, uint32_t hash) {
+  if ((m_Size + 1) * 2 > m_Slots.load(std::memory_order_relaxed)->mask + 1) grow();
+
+  Key::Atom* atom = Key::createAtom(key, hash, m_Resource);
+  atom->interned = true;
+  atom->references.store(Key::IMMORTAL, std::memory_order_relaxed);
+
+  Slots& slots = *m_Slots.load(std::memory_order_relaxed);
+  size_t slot = hash & slots.mask;
+  while (slots.entries[slot].load(std::memory_order_relaxed) != nullptr) slot = (slot + 1) & slots.mask;
+  slots.entries[slot].store(atom, std::memory_order_release);
+  m_Size++;
+  return atom;
+}
+
+void KeyTable::grow() {
+  const Slots& current = *m_Slots.load(std::memory_order_relaxed);
+  auto slots = std::make_unique<Slots>((current.mask + 1) * 2);
+
+  for (size_t i = 0; i <= current.mask; i++) {
+    const Key::Atom* atom = current.entries[i].load(std::memory_order_relaxed);
+    if (atom == nullptr) continue;
+    size_t slot = atom->hash & slots->mask;
+    while (slots->entries[slot].load(std::memory_order_relaxed) != nullptr) slot = (slot + 1) & slots->mask;
+    slots->entries[slot].store(atom, std::memory_order_relaxed);
+  }
+
+  m_Slots.store(slots.get(), std::memory_order_release);
+  m_Generations.emplace_back(std::move(slots));
+}
+
+size_t KeyTable::size() const {
+  return m_Size;
+}
+
+KeyTable& KeyTable::global() {
+  static auto* table = new KeyTable(true, std::pmr::new_delete_resource());  // Never destroyed, keys stay valid until exit
+  return *table;
+}
+
+} // namespace nbt
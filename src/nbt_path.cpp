@@ -0,0 +1,114 @@
+#include "nbt/nbt_path.hpp"
+
+#include <charconv>
+#include <stdexcept>
+
+namespace nbt {
+
+PathSet::Node& childNode(PathSet::Node& parent, std::string_view name, int64_t index) {
+  for (auto& child : parent.children) {
+    if (child.index == index && child.name == name) return child;
+  }
+  parent.children.push_back({std::string(name), index, false, {}});
+  return parent.children.back();
+}
+
+void mergeNode(PathSet::Node& into, const PathSet::Node& from) {
+  into.selected |= from.selected;
+  for (const auto& child : from.children) {
+    mergeNode(childNode(into, child.name, child.index), child);
+  }
+}
+
+/**
+ * Copies the paths under a [*] selector into its sibling [n] selectors, so that one node describes each element.
+ */
+void normalizeNode(PathSet::Node& node) {
+  for (const auto& child : node.children) {
+    if (child.index != PathSet::Node::ALL) continue;
+
+    PathSet::Node all = child;
+    for (auto& sibling : node.children) {
+      if (sibling.index >= 0) mergeNode(sibling, all);
+    }
+    break;
+  }
+
+  for (auto& child : node.children) normalizeNode(child);
+}
+
+const PathSet::Node* PathSet::Node::findKey(std::string_view key) const {
+  for (const auto& child : children) {
+    if (!child.isListSelector() && child.name == key) return &child;
+  }
+  return nullptr;
+}
+
+const PathSet::Node* PathSet::Node::findIndex(size_t elementIndex) const {
+  const Node* all = nullptr;
+  for (const auto& child : children) {
+    if (child.index == static_cast<int64_t>(elementIndex)) return &child;
+    if (child.index == ALL) all = &child;
+  }
+  return all;
+}
+
+PathSet::PathSet() : m_Root{{}, Node::KEY, false, {}} {}
+
+PathSet::PathSet(std::initializer_list<std::string_view> paths) : PathSet() {
+  for (auto path : paths) add(path);
+}
+
+std::vector<PathSet::Segment> PathSet::parse(std::string_view path) {
+  std::vector<Segment> segments;
+  size_t position = 0;
+
+  while (true) {
+    size_t end = path.find_first_of(".[", position);
+    segments.push_back({path.substr(position, end - position), Node::KEY});
+    position = end;
+
+    while (position < path.size() && path[position] == '[') {
+      size_t close = path.find(']', position);
+      if (close == std::string_view::npos) throw std::runtime_error("unterminated list selector in nbt path");
+
+      std::string_view selector = path.substr(position + 1, close - position - 1);
+      int64_t index = Node::ALL;
+      if (selector != "*") {
+        auto result = std::from_chars(selector.data(), selector.data() + selector.size(), index);
+        if (selector.empty() || selector.find_first_not_of("0123456789") != std::string_view::npos || result.ec != std::errc()) {
+          throw std::runtime_error("invalid list selector in nbt path");
+        }
+      }
+
+      segments.push_back({{}, index});
+      position = close + 1;
+    }
+
+    if (position >= path.size()) break;
+    if (path[position] != '.') throw std::runtime_error("invalid nbt path");
+    position++;
+  }
+
+  return segments;
+}
+
+void PathSet::add(std::string_view path) {
+  Node* node = &m_Root;
+  for (const auto& segment : parse(path)) {
+    node = &childNode(*node, segment.name, segment.index);
+  }
+
+  node->selected = true;
+  normalizeNode(m_Root);
+}
+
+const PathSet::Node& PathSet::getRoot() const {
+  return m_Root;
+}
+
+bool PathSet::empty() const {
+  return m_Root.children.empty();
+}
+
+} // namespace nbt
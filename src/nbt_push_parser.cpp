@@ -0,0 +1,369 @@
+#include "nbt/nbt_push_parser.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include "budget.hpp"
+#include "buffer_input.hpp"
+#include "modified_utf.hpp"
+#include "nbt/nbt.hpp"
+#include "primitive.hpp"
+
+namespace nbt {
+
+struct PushParser::Frame {
+  Key key;          // Name in the parent compound
+  Value container;  // List or compound. The bottom frame is the document, which ends after its first tag
+  size_t remaining; // Elements left, for lists of lists, strings, arrays and compounds
+};
+
+PushParser::PushParser(const ReaderOptions& options) : m_Resource(options.resource), m_Keys(options.keyTable), m_Limits(options.limits), m_String(options.resource) {
+  reset();
+}
+
+PushParser::~PushParser() = default;
+
+PushParser::Status PushParser::feed(const void* data, size_t length) {
+  m_Position = reinterpret_cast<const char*>(data);
+  m_End = m_Position + length;
+
+  if (m_Status == Status::NEED_MORE_DATA && length != 0) {
+    try {
+      while (step()) {}
+      if (m_State == State::DONE) m_Status = Status::DONE;
+    } catch (const std::exception& e) {
+      m_Status = Status::INVALID;
+      m_Error = e.what();
+    }
+  }
+
+  m_Consumed = static_cast<size_t>(m_Position - reinterpret_cast<const char*>(data));
+  return m_Status;
+}
+
+size_t PushParser::getConsumed() const {
+  return m_Consumed;
+}
+
+PushParser::Status PushParser::getStatus() const {
+  return m_Status;
+}
+
+const std::string& PushParser::getError() const {
+  return m_Error;
+}
+
+Compound PushParser::takeDocument() {
+  if (m_Status != Status::DONE) throw std::runtime_error("nbt document is not complete");
+
+  Compound document = std::move(m_Stack.front().container.getCompound());
+  reset();
+
+  if constexpr (nbt::config::omitRootTag()) { //NOLINT
+    if (document.size() == 1 && document.hasKey("")) return std::move(document[""].getCompound());
+  }
+  return document;
+}
+
+void PushParser::reset() {
+  m_Status = Status::NEED_MORE_DATA;
+  m_State = State::TYPE;
+  m_Error.clear();
+  m_Consumed = 0;
+  m_Position = m_End = nullptr;
+  m_Budget = std::make_unique<Budget>(m_Limits);
+  m_Stack.clear();
+  m_Stack.push_back({Key(), Compound(m_Resource), 0});
+  m_Type = Type::COMPOUND;
+  m_Remaining = 0;
+  m_Filled = 0;
+  m_TokenSize = 0;
+}
+
+/**
+ * Advances the state machine by one field.
+ * @return Returns false once the fragment is exhausted or the document is complete.
+ */
+bool PushParser::step() {
+  switch (m_State) {
+    case State::TYPE: {
+      const char* token = take(1);
+      if (token == nullptr) return false;
+
+      m_Type = static_cast<Type>(*token);
+      if (m_Type == static_cast<Type>(0)) {
+        if (m_Stack.size() == 1) {
+          m_State = State::DONE;  // An empty document
+          return false;
+        }
+        close();
+      } else {
+        m_State = State::NAME_LENGTH;
+      }
+      return true;
+    }
+    case State::NAME_LENGTH: {
+      const char* token = take(2);
+      if (token == nullptr) return false;
+
+      m_Name.resize(Primitive<uint16_t>::load(token));
+      m_Filled = 0;
+      m_State = State::NAME;
+      return true;
+    }
+    case State::NAME:
+      if (!fill(m_Name.data(), m_Name.size())) return false;
+      m_Budget->charge(1, sizeof(Value) + m_Name.size());
+      m_Key = m_Keys != nullptr ? m_Keys->intern(m_Name) : Key(m_Name, m_Resource);
+      m_State = State::PAYLOAD;
+      return true;
+    case State::PAYLOAD:
+      if (size_t size = fixedPayloadSize(m_Type); size != 0) {
+        const char* token = take(size);
+        if (token == nullptr) return false;
+
+        switch (m_Type) {
+          case Type::BYTE: deliver(std::move(m_Key), Primitive<int8_t>::load(token));
+            break;
+          case Type::SHORT: deliver(std::move(m_Key), Primitive<int16_t>::load(token));
+            break;
+          case Type::INT: deliver(std::move(m_Key), Primitive<int32_t>::load(token));
+            break;
+          case Type::LONG: deliver(std::move(m_Key), Primitive<int64_t>::load(token));
+            break;
+          case Type::FLOAT: deliver(std::move(m_Key), Primitive<float>::load(token));
+            break;
+          default: deliver(std::move(m_Key), Primitive<double>::load(token));
+        }
+        return true;
+      }
+      beginPayload();
+      return true;
+    case State::STRING_LENGTH: {
+      const char* token = take(2);
+      if (token == nullptr) return false;
+
+      auto length = Primitive<uint16_t>::load(token);
+      m_Budget->charge(0, length);
+      m_String = String(m_Resource);
+      m_String.resize(length);
+      m_Filled = 0;
+      m_State = State::STRING;
+      return true;
+    }
+    case State::STRING:
+      if (!fill(m_String.data(), m_String.size())) return false;
+      m_String.resize(utf::decodeUTF(m_String.data(), m_String.size(), m_String.data()));  // Decodes in place
+      deliver(std::move(m_Key), std::move(m_String));
+      return true;
+    case State::ARRAY_LENGTH: {
+      const char* token = take(4);
+      if (token == nullptr) return false;
+
+      auto length = Primitive<int32_t>::load(token);
+      if (length < 0) throw std::runtime_error("negative nbt array length");
+      m_Budget->checkLength(static_cast<size_t>(length));
+
+      switch (m_Type) {
+        case Type::BYTE_ARRAY: m_Value = ByteArray(m_Resource);
+          m_Budget->charge(0, static_cast<size_t>(length));
+          break;
+        case Type::INT_ARRAY: m_Value = IntArray(m_Resource);
+          m_Budget->charge(0, static_cast<size_t>(length) * sizeof(int32_t));
+          break;
+        default: m_Value = LongArray(m_Resource);
+          m_Budget->charge(0, static_cast<size_t>(length) * sizeof(int64_t));
+      }
+      m_Remaining = static_cast<size_t>(length);
+      m_State = State::ELEMENTS;
+      return true;
+    }
+    case State::ELEMENTS:
+      if (!readElements()) return false;
+      if (m_Type == Type::LIST) {
+        close();
+      } else {
+        deliver(std::move(m_Key), std::move(m_Value));
+      }
+      return true;
+    case State::LIST_HEADER: {
+      const char* token = take(5);
+      if (token == nullptr) return false;
+
+      auto elementType = static_cast<Type>(token[0]);
+      auto length = Primitive<int32_t>::load(token + 1);
+      if (elementType == static_cast<Type>(0) || length <= 0) {
+        open(List(elementType, m_Resource), 0);
+        close();
+        return true;
+      }
+
+      m_Budget->checkLength(static_cast<size_t>(length));
+      open(List(elementType, m_Resource), static_cast<size_t>(length));
+      if (size_t elementSize = fixedPayloadSize(elementType); elementSize != 0) {
+        m_Budget->charge(static_cast<size_t>(length), static_cast<size_t>(length) * elementSize);
+        m_Remaining = static_cast<size_t>(length);  // Read in bulk into the list's typed storage
+        m_State = State::ELEMENTS;
+      } else {
+        m_Budget->charge(1, sizeof(Value));
+        m_Type = elementType;
+        m_State = State::PAYLOAD;
+      }
+      return true;
+    }
+    default: return false;
+  }
+}
+
+/**
+ * Starts reading the payload of a variable length tag of type m_Type.
+ */
+void PushParser::beginPayload() {
+  switch (m_Type) {
+    case Type::STRING: m_State = State::STRING_LENGTH;
+      break;
+    case Type::BYTE_ARRAY:
+    case Type::INT_ARRAY:
+    case Type::LONG_ARRAY: m_State = State::ARRAY_LENGTH;
+      break;
+    case Type::LIST: m_State = State::LIST_HEADER;
+      break;
+    case Type::COMPOUND: open(Compound(m_Resource), 0);
+      m_State = State::TYPE;
+      break;
+    default: throw std::runtime_error("invalid nbt type");
+  }
+}
+
+/**
+ * Pushes a list or compound named m_Key, which receives the following tags until it is closed.
+ */
+void PushParser::open(Value container, size_t remaining) {
+  m_Budget->enter();
+  m_Stack.push_back({std::move(m_Key), std::move(container), remaining});
+  m_Type = m_Stack.back().container.getType();
+}
+
+void PushParser::close() {
+  Frame frame = std::move(m_Stack.back());
+  m_Stack.pop_back();
+  m_Budget->leave();
+  deliver(std::move(frame.key), std::move(frame.container));
+}
+
+/**
+ * Adds a completed tag to the innermost open container, closing the lists it completes in turn.
+ */
+void PushParser::deliver(Key key, Value value) {
+  while (true) {
+    Frame& top = m_Stack.back();
+    if (top.container.getType() == Type::COMPOUND) {
+      top.container.getCompound().insert(std::move(key), std::move(value));
+      m_State = m_Stack.size() == 1 ? State::DONE : State::TYPE;
+      return;
+    }
+
+    List& list = top.container.getList();
+    list.pushBack(std::move(value));
+    if (--top.remaining != 0) {
+      m_Budget->charge(1, sizeof(Value));
+      m_Type = list.getType();
+      m_State = State::PAYLOAD;
+      return;
+    }
+
+    key = std::move(top.key);
+    value = std::move(top.container);
+    m_Stack.pop_back();
+    m_Budget->leave();
+  }
+}
+
+/**
+ * Continues reading the elements of the array in m_Value, or of the primitive list on top of the stack.
+ * @return Returns whether every element has been read.
+ */
+bool PushParser::readElements() {
+  if (m_Type == Type::LIST) {
+    List& list = m_Stack.back().container.getList();
+    switch (list.getType()) {
+      case Type::BYTE: return readElements(list.getBytes());
+      case Type::SHORT: return readElements(list.getShorts());
+      case Type::INT: return readElements(list.getInts());
+      case Type::LONG: return readElements(list.getLongs());
+      case Type::FLOAT: return readElements(list.getFloats());
+      default: return readElements(list.getDoubles());
+    }
+  }
+
+  switch (m_Type) {
+    case Type::BYTE_ARRAY: return readElements(m_Value.getByteArray());
+    case Type::INT_ARRAY: return readElements(m_Value.getIntArray());
+    default: return readElements(m_Value.getLongArray());
+  }
+}
+
+/**
+ * Appends the whole elements available in the fragment to values, which grow with the data received rather than with
+ * the announced length.
+ */
+template<typename T>
+bool PushParser::readElements(std::pmr::vector<T>& values) {
+  while (m_Remaining != 0) {
+    size_t count = m_TokenSize == 0 ? std::min(m_Remaining, available() / sizeof(T)) : 0;
+    if (count == 0) {  // An element split across fragments
+      const char* token = take(sizeof(T));
+      if (token == nullptr) return false;
+
+      values.push_back(Primitive<T>::load(token));
+      m_Remaining--;
+      continue;
+    }
+
+    size_t offset = values.size();
+    values.resize(offset + count);
+    T* destination = values.data() + offset;
+    std::memcpy(destination, m_Position, count * sizeof(T));
+    networkCopy(destination, destination, count);
+    m_Position += count * sizeof(T);
+    m_Remaining -= count;
+  }
+  return true;
+}
+
+/**
+ * @return Returns the next size bytes, or nullptr if the fragment ends first, in which case the bytes received are kept
+ * until the next fragment completes them.
+ */
+const char* PushParser::take(size_t size) {
+  if (m_TokenSize == 0 && available() >= size) {
+    const char* position = m_Position;
+    m_Position += size;
+    return position;
+  }
+
+  size_t count = std::min(size - m_TokenSize, available());
+  std::memcpy(m_Token + m_TokenSize, m_Position, count);
+  m_TokenSize += count;
+  m_Position += count;
+  if (m_TokenSize < size) return nullptr;
+
+  m_TokenSize = 0;
+  return m_Token;
+}
+
+/**
+ * Copies the fragment's bytes into destination until it holds length bytes.
+ * @return Returns whether destination is complete.
+ */
+bool PushParser::fill(char* destination, size_t length) {
+  size_t count = std::min(length - m_Filled, available());
+  std::memcpy(destination + m_Filled, m_Position, count);
+  m_Filled += count;
+  m_Position += count;
+  return m_Filled == length;
+}
+
+} // namespace nbt
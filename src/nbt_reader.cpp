@@ -2,150 +2,167 @@
 
 #include <stdexcept>
 
-#include "byteswap.hpp"
-#include "primitive.hpp"
-#include "modified_utf.hpp"
+#include "buffer_input.hpp"
+#include "codec.hpp"
+#include "compression.hpp"
+#include "decoder.hpp"
+#include "event_decoder.hpp"
+#include "mapped_file.hpp"
 #include "nbt/nbt.hpp"
-
-#include <sstream>
+#include "stream_input.hpp"
 
 namespace nbt {
 
-class PointerInputBuffer : public std::basic_streambuf<char> {
- public:
-  PointerInputBuffer(const char* data, size_t length) {
-    char* dataBuffer = const_cast<char*>(data);
-    setg(dataBuffer, dataBuffer, dataBuffer + length);
+Compound unwrapRootTag(Compound compound) {
+  if constexpr (nbt::config::omitRootTag()) { //NOLINT
+    if (compound.size() == 1 && compound.hasKey("")) return std::move(compound[""].getCompound());
   }
-};
 
-void readNextPair(Compound& compound, std::istream& in);
+  return compound;
+}
 
-Compound Reader::parse(const void* data, size_t length) {
-  PointerInputBuffer streamBuf(reinterpret_cast<const char*>(data), length);
-  std::istream in(&streamBuf);
-  return read(in);
+Compound Reader::parse(const void* data, size_t length, std::pmr::memory_resource* resource) {
+  ReaderOptions options;
+  options.resource = resource;
+  return parse(data, length, options);
 }
 
-Compound Reader::read(std::istream& in) {
-  Compound compound;
-  while (!in.eof()) {
-    int peek = in.peek();
-    if (peek == EOF) break;
-    if (peek == 0) break; // TAG_End
+template<typename Codec, typename Input>
+Compound decodeDocument(Input& in, const ReaderOptions& options) {
+  Decoder<Input, Codec> decoder(in, options.resource, options.keyTable);
+  decoder.setParallel(options.pool, options.parallelThreshold);
+  if (!options.limits.isUnlimited()) decoder.setLimits(options.limits);
+  if (options.paths == nullptr) return unwrapRootTag(decoder.readDocument());
 
-    readNextPair(compound, in);
+  if constexpr (nbt::config::omitRootTag()) { //NOLINT
+    PathSet::Node root{{}, PathSet::Node::KEY, false, {options.paths->getRoot()}};  // Paths continue below the root tag
+    return unwrapRootTag(decoder.readDocument(root));
   }
 
-  if constexpr (nbt::config::omitRootTag()) { //NOLINT
-    if (compound.size() == 1 && compound.hasKey("")) return std::move(compound[""].getCompound());
+  return decoder.readDocument(options.paths->getRoot());
+}
+
+/**
+ * Selects the decoder specialized for options.format.
+ */
+template<typename Input>
+Compound decodeFormat(Input& in, const ReaderOptions& options) {
+  switch (options.format) {
+    case Format::JAVA: return decodeDocument<JavaCodec>(in, options);
+    case Format::JAVA_NETWORK: return decodeDocument<JavaNetworkCodec>(in, options);
+    case Format::BEDROCK: return decodeDocument<BedrockCodec>(in, options);
+    case Format::BEDROCK_NETWORK: return decodeDocument<BedrockNetworkCodec>(in, options);
+    default: throw std::runtime_error("invalid nbt format");
+  }
+}
+
+Compound Reader::parse(const void* data, size_t length, const ReaderOptions& options) {
+  const char* begin = reinterpret_cast<const char*>(data);
+  if (detectCompression(begin, length) != Compression::NONE) {
+    InflateInput in(begin, length);
+    return decodeFormat(in, options);
   }
 
-  return std::move(compound);
+  BufferInput in(begin, begin + length);
+  return decodeFormat(in, options);
 }
 
-std::istream& operator>>(std::istream& in, Type& type) {
-  in.read(reinterpret_cast<char*>(&type), sizeof(Type));
-  return in;
+Compound Reader::read(std::istream& in, std::pmr::memory_resource* resource) {
+  ReaderOptions options;
+  options.resource = resource;
+  return read(in, options);
 }
 
-std::istream& operator>>(std::istream& in, std::string& string) {
-  auto stringLength = Primitive<uint16_t>::readFrom(in);
-  string.resize(stringLength);
-  in.read(string.data(), stringLength);
-  return in;
+/**
+ * @return Returns whether the stream starts with a gzip or zlib header, judged by its first byte.
+ */
+bool isCompressed(std::istream& in) {
+  int peek = in.peek();
+  if (peek == EOF) return false;
+
+  char first = static_cast<char>(peek);
+  return detectCompression(&first, 1) != Compression::NONE;
 }
 
-Value readValue(Type type, std::istream& in) {
-  Value nbtValue;
+Compound Reader::read(std::istream& in, const ReaderOptions& options) {
+  if (isCompressed(in)) {
+    InflateInput input(in);
+    Compound document = decodeFormat(input, options);
+    input.finish();
+    return document;
+  }
 
-  switch (type) {
-    case Type::BYTE: {
-      nbtValue = Primitive<int8_t>::readFrom(in);
-      break;
-    }
-    case Type::SHORT: {
-      nbtValue = Primitive<int16_t>::readFrom(in);
-      break;
-    }
-    case Type::INT: {
-      nbtValue = Primitive<int32_t>::readFrom(in);
-      break;
-    }
-    case Type::LONG: {
-      nbtValue = Primitive<int64_t>::readFrom(in);
-      break;
-    }
-    case Type::FLOAT: {
-      nbtValue = Primitive<float>::readFrom(in);
-      break;
-    }
-    case Type::DOUBLE: {
-      nbtValue = Primitive<double>::readFrom(in);
-      break;
-    }
-    case Type::BYTE_ARRAY: {
-      nbtValue = Array<int8_t>::readFrom(in);
-      break;
-    }
-    case Type::INT_ARRAY: {
-      nbtValue = Array<int32_t>::readFrom(in);
-      break;
-    }
-    case Type::LONG_ARRAY: {
-      nbtValue = Array<int64_t>::readFrom(in);
-      break;
-    }
-    case Type::STRING: {
-      nbtValue = utf::readUTF(in);
-      break;
-    }
-    case Type::LIST: {
-      Type listType;
-      in >> listType;
-      if (static_cast<Type>(0) == listType) {
-        nbtValue = List();
-        break;
-      }
+  StreamInput input(in);
+  return decodeFormat(input, options);
+}
 
-      auto arrayLength = Primitive<int32_t>::readFrom(in);
+Compound Reader::parseFile(const std::string& path, const ReaderOptions& options) {
+  MappedFile file(path);
+  file.adviseSequential();
+  return parse(file.data(), file.size(), options);
+}
 
-      List list(listType);
+void Reader::visit(const void* data, size_t length, Visitor& visitor) {
+  const char* begin = reinterpret_cast<const char*>(data);
+  if (detectCompression(begin, length) != Compression::NONE) {
+    InflateInput in(begin, length);
+    EventDecoder<InflateInput>(in, visitor).readDocument();
+    return;
+  }
 
-      for (int32_t i = 0; i < arrayLength; i++) {
-        list.pushBack(readValue(listType, in));
-      }
+  BufferInput in(begin, begin + length);
+  EventDecoder<BufferInput>(in, visitor).readDocument();
+}
 
-      nbtValue = std::move(list);
-      break;
-    }
-    case Type::COMPOUND: {
-      Compound elementCompound;
-      int32_t peek = in.peek();
-      while (peek != 0) {
-        readNextPair(elementCompound, in);
-        peek = in.peek();
-      }
-      in.ignore(1);
-
-      nbtValue = std::move(elementCompound);
-      break;
+void Reader::visit(std::istream& in, Visitor& visitor) {
+  if (isCompressed(in)) {
+    InflateInput input(in);
+    EventDecoder<InflateInput>(input, visitor).readDocument();
+    input.finish();
+    return;
+  }
+
+  StreamInput input(in);
+  EventDecoder<StreamInput>(input, visitor).readDocument();
+}
+
+CompoundView Reader::view(const void* data, size_t length) {
+  const char* begin = reinterpret_cast<const char*>(data);
+  CompoundView document(begin, begin + length);
+
+  if constexpr (nbt::config::omitRootTag()) { //NOLINT
+    auto it = document.begin();
+    if (it != document.end() && it->name.empty() && it->value.getType() == Type::COMPOUND && std::next(it) == document.end()) {
+      return it->value.getCompound();
     }
-    default:throw std::runtime_error("invalid nbt type");
   }
 
-  return std::move(nbtValue);
+  return document;
+}
+
+FileView Reader::viewFile(const std::string& path) {
+  return FileView(path);
+}
+
+FileView::FileView(const std::string& path) : m_File(std::make_unique<MappedFile>(path)) {
+  if (detectCompression(m_File->data(), m_File->size()) != Compression::NONE) {
+    throw std::runtime_error("compressed nbt cannot be viewed, use Reader::parseFile() " + path);
+  }
+  m_Root = Reader::view(m_File->data(), m_File->size());
 }
 
-void readNextPair(Compound& compound, std::istream& in) {
-  Type type;
-  in >> type;
+FileView::~FileView() = default;
+
+FileView::FileView(FileView&& other) noexcept = default;
 
-  std::string key;
-  in >> key;
+FileView& FileView::operator=(FileView&& other) noexcept = default;
+
+const char* FileView::data() const {
+  return m_File->data();
+}
 
-  Value value = readValue(type, in);
-  compound.insert(std::move(key), std::move(value));
+size_t FileView::size() const {
+  return m_File->size();
 }
 
-} // namespace nbt
\ No newline at end of file
+} // namespace nbt
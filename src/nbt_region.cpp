@@ -0,0 +1,245 @@
+#include "nbt/nbt_region.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+
+#include "compression.hpp"
+#include "mapped_file.hpp"
+#include "primitive.hpp"
+
+namespace nbt {
+
+RegionFile::RegionFile(const std::string& path) : m_File(std::make_unique<MappedFile>(path)) {
+  if (m_File->size() < 2 * SECTOR_SIZE) throw std::runtime_error("region file is missing its header: " + path);
+}
+
+RegionFile::~RegionFile() = default;
+RegionFile::RegionFile(RegionFile&& other) noexcept = default;
+RegionFile& RegionFile::operator=(RegionFile&& other) noexcept = default;
+
+static size_t chunkIndex(int32_t x, int32_t z) {
+  return static_cast<size_t>(x & 31) + static_cast<size_t>(z & 31) * 32;
+}
+
+bool RegionFile::hasChunk(int32_t x, int32_t z) const {
+  return getChunkInfo(x, z).sector != 0;
+}
+
+RegionFile::ChunkInfo RegionFile::getChunkInfo(int32_t x, int32_t z) const {
+  size_t index = chunkIndex(x, z);
+  uint32_t location = Primitive<uint32_t>::load(m_File->data() + index * 4);
+  uint32_t timestamp = Primitive<uint32_t>::load(m_File->data() + SECTOR_SIZE + index * 4);
+  return {location >> 8, static_cast<uint8_t>(location & 0xFF), timestamp};
+}
+
+std::vector<std::pair<int32_t, int32_t>> RegionFile::getChunks() const {
+  std::vector<std::pair<int32_t, int32_t>> chunks;
+  for (int32_t z = 0; z < 32; z++) {
+    for (int32_t x = 0; x < 32; x++) {
+      if (hasChunk(x, z)) chunks.emplace_back(x, z);
+    }
+  }
+  return chunks;
+}
+
+std::string_view RegionFile::getChunkData(int32_t x, int32_t z, Compression& compression) const {
+  compression = Compression::NONE;
+
+  ChunkInfo info = getChunkInfo(x, z);
+  if (info.sector == 0) return {};
+
+  size_t offset = static_cast<size_t>(info.sector) * SECTOR_SIZE;
+  size_t capacity = static_cast<size_t>(info.sectorCount) * SECTOR_SIZE;
+  if (info.sector < 2 || offset + capacity > m_File->size() || capacity < 5) throw std::runtime_error("region chunk lies outside of the file");
+
+  const char* chunk = m_File->data() + offset;
+  uint32_t length = Primitive<uint32_t>::load(chunk);
+  if (length == 0 || length > capacity - 4) throw std::runtime_error("invalid region chunk length");
+
+  switch (static_cast<uint8_t>(chunk[4])) {
+    case 1: compression = Compression::GZIP;
+      break;
+    case 2: compression = Compression::ZLIB;
+      break;
+    case 3: compression = Compression::NONE;
+      break;
+    default: throw std::runtime_error("unsupported region chunk compression");  // LZ4, custom and external .mcc chunks
+  }
+  return {chunk + 5, length - 1};
+}
+
+std::vector<char> RegionFile::inflateChunk(int32_t x, int32_t z) const {
+  Compression compression;
+  std::string_view data = getChunkData(x, z, compression);
+  if (compression == Compression::NONE) return {data.begin(), data.end()};
+
+  std::vector<char> document;
+  inflateTo(document, data.data(), data.size());
+  return document;
+}
+
+Compound RegionFile::readChunk(int32_t x, int32_t z, const ReaderOptions& options) const {
+  Compression compression;
+  std::string_view data = getChunkData(x, z, compression);
+  if (data.empty()) return Compound(options.resource);
+
+  return Reader::parse(data.data(), data.size(), options);  // Detects the compression from the data itself
+}
+
+std::vector<Compound> RegionFile::readChunks(const std::vector<std::pair<int32_t, int32_t>>& chunks, const ReaderOptions& options, ThreadPool& pool) const {
+  std::vector<Compound> compounds;
+  compounds.reserve(chunks.size());
+  for (size_t i = 0; i < chunks.size(); i++) compounds.emplace_back(options.resource);  // Assignments below then move
+
+  pool.run(chunks.size(), [&](size_t i) {
+    compounds[i] = readChunk(chunks[i].first, chunks[i].second, options);
+  });
+  return compounds;
+}
+
+RegionWriter::RegionWriter(std::string path, Compression compression) : m_Path(std::move(path)), m_Compression(compression) {}
+
+/**
+ * @return Returns the region id of a compression, stored in front of every chunk.
+ */
+static uint8_t compressionId(Compression compression) {
+  switch (compression) {
+    case Compression::GZIP: return 1;
+    case Compression::ZLIB: return 2;
+    default: return 3;
+  }
+}
+
+/**
+ * Encodes a chunk as stored in a region: length, compression id and compressed document, padded to whole sectors.
+ */
+static std::vector<char> encodeChunk(const Compound& compound, Compression compression) {
+  std::vector<char> record(5);
+  std::vector<char> document = Writer::writeToBuffer(compound);
+  deflateTo(record, document.data(), document.size(), compression);
+
+  Primitive<uint32_t>::store(record.data(), static_cast<uint32_t>(record.size() - 4));
+  record[4] = static_cast<char>(compressionId(compression));
+
+  size_t sectors = (record.size() + RegionFile::SECTOR_SIZE - 1) / RegionFile::SECTOR_SIZE;
+  if (sectors > 0xFF) throw std::runtime_error("chunk too large for a region file");
+  record.resize(sectors * RegionFile::SECTOR_SIZE);
+  return record;
+}
+
+/**
+ * Finds the first run of count free sectors, growing used when the run extends past the end of the file.
+ * @return Returns the first sector of the run, which is marked as used.
+ */
+static size_t allocateSectors(std::vector<bool>& used, size_t count) {
+  size_t start = 2;
+  size_t length = 0;
+  for (size_t sector = 2; sector < used.size() && length < count; sector++) {
+    if (used[sector]) {
+      start = sector + 1;
+      length = 0;
+    } else {
+      length++;
+    }
+  }
+
+  if (start + count > used.size()) used.resize(start + count, false);
+  std::fill(used.begin() + static_cast<std::ptrdiff_t>(start), used.begin() + static_cast<std::ptrdiff_t>(start + count), true);
+  return start;
+}
+
+void RegionWriter::write(const std::vector<Chunk>& chunks, ThreadPool& pool) {
+  std::fstream file(m_Path, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+  if (!file.is_open()) {
+    std::ofstream(m_Path, std::ios_base::binary);
+    file.open(m_Path, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    if (!file.is_open()) throw std::runtime_error("failed to open " + m_Path);
+  }
+
+  std::vector<char> header(2 * RegionFile::SECTOR_SIZE, 0);
+  file.seekg(0, std::ios_base::end);
+  auto fileSize = static_cast<size_t>(file.tellg());
+  if (fileSize != 0) {
+    if (fileSize < header.size()) throw std::runtime_error("region file is missing its header: " + m_Path);
+    file.seekg(0);
+    file.read(header.data(), static_cast<std::streamsize>(header.size()));
+  }
+
+  // Sectors in use, including the ones of chunks about to be replaced, which stay reserved until the next call.
+  std::vector<bool> used((std::max(fileSize, header.size()) + RegionFile::SECTOR_SIZE - 1) / RegionFile::SECTOR_SIZE, false);
+  used[0] = used[1] = true;
+  for (size_t i = 0; i < RegionFile::CHUNKS; i++) {
+    uint32_t location = Primitive<uint32_t>::load(header.data() + i * 4);
+    size_t sector = location >> 8;
+    size_t end = std::min(sector + (location & 0xFF), used.size());
+    for (; sector != 0 && sector < end; sector++) used[sector] = true;
+  }
+
+  // Only the last update of a chunk counts.
+  std::vector<const Chunk*> updates;
+  std::vector<size_t> slots(RegionFile::CHUNKS, SIZE_MAX);
+  for (const auto& chunk : chunks) {
+    size_t& slot = slots[chunkIndex(chunk.x, chunk.z)];
+    if (slot == SIZE_MAX) {
+      slot = updates.size();
+      updates.push_back(&chunk);
+    } else {
+      updates[slot] = &chunk;
+    }
+  }
+
+  std::vector<std::vector<char>> records(updates.size());
+  pool.run(updates.size(), [&](size_t i) {
+    if (updates[i]->compound != nullptr) records[i] = encodeChunk(*updates[i]->compound, m_Compression);
+  });
+
+  struct Allocation {
+    size_t sector;
+    const std::vector<char>* record;
+  };
+  std::vector<Allocation> allocations;
+
+  auto timestamp = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+  for (size_t i = 0; i < updates.size(); i++) {
+    size_t index = chunkIndex(updates[i]->x, updates[i]->z);
+    uint32_t location = 0;
+    if (!records[i].empty()) {
+      size_t sectors = records[i].size() / RegionFile::SECTOR_SIZE;
+      size_t sector = allocateSectors(used, sectors);
+      if (sector > 0xFFFFFF) throw std::runtime_error("region file is full");
+
+      allocations.push_back({sector, &records[i]});
+      location = static_cast<uint32_t>(sector << 8 | sectors);
+    }
+
+    Primitive<uint32_t>::store(header.data() + index * 4, location);
+    Primitive<uint32_t>::store(header.data() + RegionFile::SECTOR_SIZE + index * 4, location == 0 ? 0 : timestamp);
+  }
+
+  // Chunks in adjacent sectors are gathered so that each contiguous run is a single write.
+  std::sort(allocations.begin(), allocations.end(), [](const Allocation& lhs, const Allocation& rhs) { return lhs.sector < rhs.sector; });
+  std::vector<char> run;
+  for (size_t i = 0; i < allocations.size();) {
+    size_t start = allocations[i].sector;
+    size_t next = start;
+    run.clear();
+    for (; i < allocations.size() && allocations[i].sector == next; i++) {
+      run.insert(run.end(), allocations[i].record->begin(), allocations[i].record->end());
+      next += allocations[i].record->size() / RegionFile::SECTOR_SIZE;
+    }
+
+    file.seekp(static_cast<std::streamoff>(start * RegionFile::SECTOR_SIZE));
+    file.write(run.data(), static_cast<std::streamsize>(run.size()));
+  }
+
+  // The header goes last, so the chunks it points to are complete by the time it does.
+  file.flush();
+  file.seekp(0);
+  file.write(header.data(), static_cast<std::streamsize>(header.size()));
+  file.flush();
+  if (!file) throw std::runtime_error("failed to write " + m_Path);
+}
+
+} // namespace nbt
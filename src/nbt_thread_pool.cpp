@@ -0,0 +1,113 @@
+#include "nbt/nbt_thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+
+namespace nbt {
+
+/**
+ * Blocks until predicate holds. Waits without a deadline, through the clock-based overload: the untimed
+ * condition_variable::wait() links against a symbol that only libstdc++ 12 and later export.
+ */
+template<typename Predicate>
+void waitUntil(std::condition_variable& condition, std::unique_lock<std::mutex>& lock, Predicate predicate) {
+  condition.wait_until(lock, std::chrono::steady_clock::time_point::max(), predicate);
+}
+
+struct ThreadPool::Job {
+  const std::function<void(size_t)>* task;
+  size_t count;
+  std::atomic<size_t> next{0};
+  size_t finished = 0;  // Guarded by m_Mutex, like the rest of the job's state below
+  std::condition_variable done;
+  std::exception_ptr error;
+};
+
+ThreadPool::ThreadPool(size_t workers) : m_Stopping(false) {
+  m_Threads.reserve(workers);
+  for (size_t i = 0; i < workers; i++) m_Threads.emplace_back([this] { work(); });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stopping = true;
+  }
+  m_Wake.notify_all();
+  for (auto& thread : m_Threads) thread.join();
+}
+
+void ThreadPool::run(size_t count, const std::function<void(size_t)>& task) {
+  if (count == 0) return;
+
+  Job job;
+  job.task = &task;
+  job.count = count;
+
+  bool shared = !m_Threads.empty() && count > 1;
+  if (shared) {
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Jobs.push_back(&job);
+    }
+    m_Wake.notify_all();
+  }
+
+  for (size_t index = job.next.fetch_add(1); index < count; index = job.next.fetch_add(1)) {
+    execute(job, index);
+  }
+
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  if (shared) {
+    auto it = std::find(m_Jobs.begin(), m_Jobs.end(), &job);
+    if (it != m_Jobs.end()) m_Jobs.erase(it);
+  }
+  waitUntil(job.done, lock, [&job] { return job.finished == job.count; });
+
+  if (job.error) std::rethrow_exception(job.error);
+}
+
+size_t ThreadPool::getConcurrency() const {
+  return m_Threads.size() + 1;
+}
+
+ThreadPool& ThreadPool::global() {
+  static auto* pool = new ThreadPool(std::max(std::thread::hardware_concurrency(), 1U) - 1);  // Never destroyed
+  return *pool;
+}
+
+void ThreadPool::work() {
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  while (true) {
+    waitUntil(m_Wake, lock, [this] { return m_Stopping || !m_Jobs.empty(); });
+    if (m_Stopping) return;
+
+    Job* job = m_Jobs.front();
+    size_t index = job->next.fetch_add(1);
+    if (index >= job->count) {
+      m_Jobs.pop_front();  // Every task of the job is claimed, its caller waits for the ones still running
+      continue;
+    }
+
+    lock.unlock();
+    execute(*job, index);
+    lock.lock();
+  }
+}
+
+void ThreadPool::execute(Job& job, size_t index) {
+  std::exception_ptr error;
+  try {
+    (*job.task)(index);
+  } catch (...) {
+    error = std::current_exception();
+  }
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if (error && !job.error) job.error = error;
+  if (++job.finished == job.count) job.done.notify_all();
+}
+
+} // namespace nbt
@@ -1,6 +1,9 @@
 #include "nbt/nbt_type.hpp"
 
+#include <atomic>
+#include <cstring>
 #include <stdexcept>
+#include <type_traits>
 
 namespace nbt {
 
@@ -11,6 +14,67 @@ inline void typeCheck(Type type) {
   }
 }
 
+template<typename T>
+inline std::pmr::memory_resource* resourceOf(const T& value) {
+  if constexpr (std::is_same_v<T, Compound> || std::is_same_v<T, List>) {
+    return value.getResource();
+  } else {
+    return value.get_allocator().resource();
+  }
+}
+
+template<typename T>
+struct Box {
+  T value;
+  std::atomic<uint32_t> references;
+};
+
+/**
+ * Moves value into an allocation from its own memory resource.
+ */
+template<typename T>
+inline Box<T>* box(T& value) {
+  void* memory = resourceOf(value)->allocate(sizeof(Box<T>), alignof(Box<T>));
+  return new(memory) Box<T>{std::move(value), {1}};
+}
+
+template<typename T>
+inline void acquire(Box<T>* box) {
+  box->references.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<typename T>
+inline void release(Box<T>* box) {
+  // A single owner cannot race with a new one, which skips the atomic decrement for unshared boxes
+  if (box->references.load(std::memory_order_acquire) != 1 && box->references.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+  std::pmr::memory_resource* resource = resourceOf(box->value);
+  box->~Box<T>();
+  resource->deallocate(box, sizeof(Box<T>), alignof(Box<T>));
+}
+
+/**
+ * Clones a shared box before its payload is modified. Compounds and lists are cloned one level deep, sharing their
+ * children in turn.
+ * @return Returns the payload, owned by box alone.
+ */
+template<typename T>
+inline T& unique(Box<T>*& box) {
+  if (box->references.load(std::memory_order_acquire) != 1) {
+    T copy = [&] {
+      if constexpr (std::is_same_v<T, Compound> || std::is_same_v<T, List>) {
+        return box->value.share();
+      } else {
+        return T(box->value, resourceOf(box->value));
+      }
+    }();
+    Box<T>* owned = nbt::box(copy);
+    release(box);
+    box = owned;
+  }
+  return box->value;
+}
+
 Value::Value(Value&& rhs) noexcept: m_Type(Type::BYTE) {
   operator=(std::move(rhs));
 }
@@ -34,100 +98,104 @@ Value& Value::operator=(const Value& rhs) noexcept {
       break;
     case Type::DOUBLE:operator=(rhs.m_Double);
       break;
-    case Type::BYTE_ARRAY:operator=(rhs.m_ByteArray);
+    case Type::BYTE_ARRAY:operator=(rhs.m_ByteArray->value);
       break;
-    case Type::STRING:operator=(rhs.m_String);
+    case Type::STRING:operator=(rhs.m_String->value);
       break;
-    case Type::LIST:operator=(rhs.m_List);
+    case Type::LIST:operator=(rhs.m_List->value);
       break;
-    case Type::COMPOUND:operator=(rhs.m_Compound);
+    case Type::COMPOUND:operator=(rhs.m_Compound->value);
       break;
-    case Type::INT_ARRAY:operator=(rhs.m_IntArray);
+    case Type::INT_ARRAY:operator=(rhs.m_IntArray->value);
       break;
-    case Type::LONG_ARRAY:operator=(rhs.m_LongArray);
+    case Type::LONG_ARRAY:operator=(rhs.m_LongArray->value);
       break;
+    default:setType(rhs.m_Type);
   }
   return *this;
 }
 
 Value& Value::operator=(Value&& rhs) noexcept {
   if (this == &rhs) return *this;
-  switch (rhs.m_Type) {
-    case Type::BYTE:operator=(rhs.m_Byte);
-      break;
-    case Type::SHORT:operator=(rhs.m_Short);
-      break;
-    case Type::INT:operator=(rhs.m_Int);
-      break;
-    case Type::LONG:operator=(rhs.m_Long);
-      break;
-    case Type::FLOAT:operator=(rhs.m_Float);
-      break;
-    case Type::DOUBLE:operator=(rhs.m_Double);
-      break;
-    case Type::BYTE_ARRAY:operator=(std::move(rhs.m_ByteArray));
-      break;
-    case Type::STRING:operator=(std::move(rhs.m_String));
-      break;
-    case Type::LIST:operator=(std::move(rhs.m_List));
-      break;
-    case Type::COMPOUND:operator=(std::move(rhs.m_Compound));
-      break;
-    case Type::INT_ARRAY:operator=(std::move(rhs.m_IntArray));
-      break;
-    case Type::LONG_ARRAY:operator=(std::move(rhs.m_LongArray));
-      break;
-  }
+
+  // Takes over rhs's payload, which may live inside the box released by setType()
+  Type type = rhs.m_Type;
+  char payload[sizeof(m_Long)];
+  std::memcpy(payload, &rhs.m_Long, sizeof(payload));
+  rhs.m_Type = static_cast<Type>(0);
+
+  setType(type);
+  std::memcpy(&m_Long, payload, sizeof(payload));
   return *this;
 }
 
 Value::Value() : m_Type(static_cast<Type>(0)) {}
 
-Value::Value(int8_t value) {
+Value::Value(int8_t value) : m_Type(Type::BYTE) {
   operator=(value);
 }
 
-Value::Value(int16_t value) {
+Value::Value(int16_t value) : m_Type(Type::BYTE) {
   operator=(value);
 }
 
-Value::Value(int32_t value) {
+Value::Value(int32_t value) : m_Type(Type::BYTE) {
   operator=(value);
 }
 
-Value::Value(int64_t value) {
+Value::Value(int64_t value) : m_Type(Type::BYTE) {
   operator=(value);
 }
 
-Value::Value(float value) {
+Value::Value(float value) : m_Type(Type::BYTE) {
   operator=(value);
 }
 
-Value::Value(double value) {
+Value::Value(double value) : m_Type(Type::BYTE) {
   operator=(value);
 }
 
-Value::Value(std::vector<int8_t> value) {
+Value::Value(ByteArray value) : m_Type(Type::BYTE) {
   operator=(std::move(value));
 }
 
-Value::Value(std::vector<int32_t> value) {
+Value::Value(IntArray value) : m_Type(Type::BYTE) {
   operator=(std::move(value));
 }
 
-Value::Value(std::vector<int64_t> value) {
+Value::Value(LongArray value) : m_Type(Type::BYTE) {
   operator=(std::move(value));
 }
 
-Value::Value(std::string string) {
+Value::Value(const std::vector<int8_t>& value) : m_Type(Type::BYTE) {
+  operator=(value);
+}
+
+Value::Value(const std::vector<int32_t>& value) : m_Type(Type::BYTE) {
+  operator=(value);
+}
+
+Value::Value(const std::vector<int64_t>& value) : m_Type(Type::BYTE) {
+  operator=(value);
+}
+
+Value::Value(String string) : m_Type(Type::BYTE) {
   operator=(std::move(string));
 }
 
-Value::Value(Compound value) {
+Value::Value(std::string_view string) : m_Type(Type::BYTE) {
+  operator=(string);
+}
+
+Value::Value(const char* string) : m_Type(Type::BYTE) {
+  operator=(string);
+}
+
+Value::Value(Compound value) : m_Type(Type::BYTE) {
   operator=(std::move(value));
 }
 
-Value::Value(List value) {
+Value::Value(List value) : m_Type(Type::BYTE) {
   operator=(std::move(value));
 }
 
@@ -171,39 +239,65 @@ Value& Value::operator=(double value) {
   return *this;
 }
 
-Value& Value::operator=(std::vector<int8_t> value) {
+Value& Value::operator=(ByteArray value) {
+  Box<ByteArray>* boxed = box(value);
   setType(Type::BYTE_ARRAY);
-  new(&m_ByteArray) std::vector<int8_t>(std::move(value));
+  m_ByteArray = boxed;
   return *this;
 }
 
-Value& Value::operator=(std::vector<int32_t> value) {
+Value& Value::operator=(IntArray value) {
+  Box<IntArray>* boxed = box(value);
   setType(Type::INT_ARRAY);
-  new(&m_IntArray) std::vector<int32_t>(std::move(value));
+  m_IntArray = boxed;
   return *this;
 }
 
-Value& Value::operator=(std::vector<int64_t> value) {
+Value& Value::operator=(LongArray value) {
+  Box<LongArray>* boxed = box(value);
   setType(Type::LONG_ARRAY);
-  new(&m_LongArray) std::vector<int64_t>(std::move(value));
+  m_LongArray = boxed;
   return *this;
 }
 
-Value& Value::operator=(std::string string) {
+Value& Value::operator=(const std::vector<int8_t>& value) {
+  return operator=(ByteArray(value.begin(), value.end()));
+}
+
+Value& Value::operator=(const std::vector<int32_t>& value) {
+  return operator=(IntArray(value.begin(), value.end()));
+}
+
+Value& Value::operator=(const std::vector<int64_t>& value) {
+  return operator=(LongArray(value.begin(), value.end()));
+}
+
+Value& Value::operator=(String string) {
+  Box<String>* boxed = box(string);
   setType(Type::STRING);
-  new(&m_String) std::string(std::move(string));
+  m_String = boxed;
   return *this;
 }
 
+Value& Value::operator=(std::string_view string) {
+  return operator=(String(string));
+}
+
+Value& Value::operator=(const char* string) {
+  return operator=(String(string));
+}
+
 Value& Value::operator=(Compound value) {
+  Box<Compound>* boxed = box(value);
   setType(Type::COMPOUND);
-  new(&m_Compound) Compound(std::move(value));
+  m_Compound = boxed;
   return *this;
 }
 
 Value& Value::operator=(List value) {
+  Box<List>* boxed = box(value);
   setType(Type::LIST);
-  new(&m_List) List(std::move(value));
+  m_List = boxed;
   return *this;
 }
 
@@ -217,30 +311,53 @@ bool Value::operator==(const Value& rhs) const {
     case Type::LONG:return m_Long == rhs.m_Long;
     case Type::FLOAT:return m_Float == rhs.m_Float;
     case Type::DOUBLE:return m_Double == rhs.m_Double;
-    case Type::BYTE_ARRAY:return m_ByteArray == rhs.m_ByteArray;
-    case Type::STRING:return m_String == rhs.m_String;
-    case Type::LIST:return m_List == rhs.m_List;
-    case Type::COMPOUND:return m_Compound == rhs.m_Compound;
-    case Type::INT_ARRAY:return m_IntArray == rhs.m_IntArray;
-    case Type::LONG_ARRAY:return m_LongArray == rhs.m_LongArray;
+    case Type::BYTE_ARRAY:return m_ByteArray == rhs.m_ByteArray || m_ByteArray->value == rhs.m_ByteArray->value;
+    case Type::STRING:return m_String == rhs.m_String || m_String->value == rhs.m_String->value;
+    case Type::LIST:return m_List == rhs.m_List || m_List->value == rhs.m_List->value;
+    case Type::COMPOUND:return m_Compound == rhs.m_Compound || m_Compound->value == rhs.m_Compound->value;
+    case Type::INT_ARRAY:return m_IntArray == rhs.m_IntArray || m_IntArray->value == rhs.m_IntArray->value;
+    case Type::LONG_ARRAY:return m_LongArray == rhs.m_LongArray || m_LongArray->value == rhs.m_LongArray->value;
     default:
       throw std::runtime_error("invalid nbt type");
   }
 }
 
+Value Value::share() const {
+  Value value;
+  switch (m_Type) {
+    case Type::BYTE_ARRAY:acquire(m_ByteArray);
+      break;
+    case Type::STRING:acquire(m_String);
+      break;
+    case Type::LIST:acquire(m_List);
+      break;
+    case Type::COMPOUND:acquire(m_Compound);
+      break;
+    case Type::INT_ARRAY:acquire(m_IntArray);
+      break;
+    case Type::LONG_ARRAY:acquire(m_LongArray);
+      break;
+    default:break;
+  }
+
+  value.m_Type = m_Type;
+  std::memcpy(&value.m_Long, &m_Long, sizeof(m_Long));
+  return value;
+}
+
 void Value::setType(Type type) {
   switch (m_Type) {
-    case Type::BYTE_ARRAY:m_ByteArray.~vector();
+    case Type::BYTE_ARRAY:release(m_ByteArray);
       break;
-    case Type::STRING:m_String.~basic_string();
+    case Type::STRING:release(m_String);
       break;
-    case Type::LIST:m_List.~List();
+    case Type::LIST:release(m_List);
       break;
-    case Type::COMPOUND:m_Compound.~Compound();
+    case Type::COMPOUND:release(m_Compound);
       break;
-    case Type::INT_ARRAY:m_IntArray.~vector();
+    case Type::INT_ARRAY:release(m_IntArray);
       break;
-    case Type::LONG_ARRAY:m_LongArray.~vector();
+    case Type::LONG_ARRAY:release(m_LongArray);
       break;
     default:break;
   }
@@ -282,95 +399,263 @@ double Value::getDouble() const {
   return m_Double;
 }
 
-std::vector<int8_t>& Value::getByteArray() {
+ByteArray& Value::getByteArray() {
   typeCheck<Type::BYTE_ARRAY>(m_Type);
-  return m_ByteArray;
+  return unique(m_ByteArray);
 }
 
-const std::vector<int8_t>& Value::getByteArray() const {
+const ByteArray& Value::getByteArray() const {
   typeCheck<Type::BYTE_ARRAY>(m_Type);
-  return m_ByteArray;
+  return m_ByteArray->value;
 }
 
-std::vector<int32_t>& Value::getIntArray() {
+IntArray& Value::getIntArray() {
   typeCheck<Type::INT_ARRAY>(m_Type);
-  return m_IntArray;
+  return unique(m_IntArray);
 }
 
-const std::vector<int32_t>& Value::getIntArray() const {
+const IntArray& Value::getIntArray() const {
   typeCheck<Type::INT_ARRAY>(m_Type);
-  return m_IntArray;
+  return m_IntArray->value;
 }
 
-std::vector<int64_t>& Value::getLongArray() {
+LongArray& Value::getLongArray() {
   typeCheck<Type::LONG_ARRAY>(m_Type);
-  return m_LongArray;
+  return unique(m_LongArray);
 }
 
-const std::vector<int64_t>& Value::getLongArray() const {
+const LongArray& Value::getLongArray() const {
   typeCheck<Type::LONG_ARRAY>(m_Type);
-  return m_LongArray;
+  return m_LongArray->value;
 }
 
-std::string& Value::getString() {
+String& Value::getString() {
   typeCheck<Type::STRING>(m_Type);
-  return m_String;
+  return unique(m_String);
 }
 
-const std::string& Value::getString() const {
+const String& Value::getString() const {
   typeCheck<Type::STRING>(m_Type);
-  return m_String;
+  return m_String->value;
 }
 
 Compound& Value::getCompound() {
   typeCheck<Type::COMPOUND>(m_Type);
-  return m_Compound;
+  return unique(m_Compound);
 }
 
 const Compound& Value::getCompound() const {
   typeCheck<Type::COMPOUND>(m_Type);
-  return m_Compound;
+  return m_Compound->value;
 }
 
 List& Value::getList() {
   typeCheck<Type::LIST>(m_Type);
-  return m_List;
+  return unique(m_List);
 }
 
 const List& Value::getList() const {
   typeCheck<Type::LIST>(m_Type);
-  return m_List;
+  return m_List->value;
+}
+
+constexpr size_t COMPOUND_INDEX_THRESHOLD = 8;
+constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+
+Compound::Compound(std::pmr::memory_resource* resource) : m_Values(resource), m_Index(resource) {
+
 }
 
 bool Compound::operator==(const Compound& rhs) const {
-  return m_Values == rhs.m_Values;
+  if (this == &rhs) return true;
+  if (size() != rhs.size()) return false;
+  for (const auto& pair : m_Values) {
+    const Value* value = rhs.get(pair.first);
+    if (value == nullptr || !(*value == pair.second)) return false;
+  }
+  return true;
+}
+
+Value& Compound::operator[](std::string_view key) {
+  size_t index = find(key, Key::hashOf(key));
+  if (index != NOT_FOUND) return m_Values[index].second;
+  return append(Key(key, getResource()));
+}
+
+Value& Compound::operator[](const Key& key) {
+  size_t index = find(key);
+  if (index != NOT_FOUND) return m_Values[index].second;
+  return append(key);
+}
+
+Value* Compound::get(std::string_view key) {
+  size_t index = find(key, Key::hashOf(key));
+  if (index == NOT_FOUND) return nullptr;
+  return &m_Values[index].second;
+}
+
+const Value* Compound::get(std::string_view key) const {
+  size_t index = find(key, Key::hashOf(key));
+  if (index == NOT_FOUND) return nullptr;
+  return &m_Values[index].second;
+}
+
+Value* Compound::get(const Key& key) {
+  size_t index = find(key);
+  if (index == NOT_FOUND) return nullptr;
+  return &m_Values[index].second;
+}
+
+const Value* Compound::get(const Key& key) const {
+  size_t index = find(key);
+  if (index == NOT_FOUND) return nullptr;
+  return &m_Values[index].second;
 }
 
-Value& Compound::operator[](const char* key) {
-  return m_Values[key];
+void Compound::insert(std::string_view key, Value value) {
+  operator[](key) = std::move(value);
 }
 
-const Value* Compound::get(const char* key) const {
-  auto it = m_Values.find(key);
-  if (it == m_Values.end()) return nullptr;
-  return &it->second;
+void Compound::insert(Key key, Value value) {
+  size_t index = find(key);
+  if (index != NOT_FOUND) {
+    m_Values[index].second = std::move(value);
+    return;
+  }
+  append(std::move(key)) = std::move(value);
 }
 
-void Compound::insert(std::string key, Value value) {
-  m_Values[std::move(key)] = std::move(value);
+bool Compound::hasKey(std::string_view key) const {
+  return find(key, Key::hashOf(key)) != NOT_FOUND;
 }
 
-bool Compound::hasKey(const char* key) const {
-  return m_Values.find(key) != m_Values.end();
+bool Compound::hasKey(const Key& key) const {
+  return find(key) != NOT_FOUND;
 }
 
-bool Compound::remove(const char* key) {
-  auto it = m_Values.find(key);
-  if (it == m_Values.end()) return false;
-  m_Values.erase(it);
+bool Compound::remove(std::string_view key) {
+  uint32_t hash = Key::hashOf(key);
+  size_t index = find(key, hash);
+  if (index == NOT_FOUND) return false;
+  m_Values.erase(m_Values.begin() + static_cast<std::ptrdiff_t>(index));
+
+  if (m_Values.size() <= COMPOUND_INDEX_THRESHOLD) {
+    m_Index.clear();
+  } else {
+    unindexEntry(index, hash);
+  }
   return true;
 }
 
+void Compound::clear() {
+  m_Values.clear();
+  m_Index.clear();
+}
+
+void Compound::reserve(size_t size) {
+  m_Values.reserve(size);
+}
+
+Compound Compound::share() const {
+  Compound compound(getResource());
+  compound.m_Values.reserve(m_Values.size());
+  for (const auto& entry : m_Values) {
+    compound.m_Values.emplace_back(entry.first, entry.second.share());
+  }
+  compound.m_Index = m_Index;
+  return compound;
+}
+
+size_t Compound::find(std::string_view key, uint32_t hash) const {
+  if (m_Index.empty()) {
+    for (size_t i = 0; i < m_Values.size(); i++) {
+      if (m_Values[i].first.hash() == hash && m_Values[i].first.view() == key) return i;
+    }
+    return NOT_FOUND;
+  }
+
+  size_t mask = m_Index.size() - 1;
+  for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+    const Slot& entry = m_Index[slot];
+    if (entry.index == 0) return NOT_FOUND;
+    if (entry.hash == hash && m_Values[entry.index - 1].first.view() == key) return entry.index - 1;
+  }
+}
+
+size_t Compound::find(const Key& key) const {
+  if (m_Index.empty()) {
+    for (size_t i = 0; i < m_Values.size(); i++) {
+      if (m_Values[i].first == key) return i;
+    }
+    return NOT_FOUND;
+  }
+
+  size_t mask = m_Index.size() - 1;
+  for (size_t slot = key.hash() & mask;; slot = (slot + 1) & mask) {
+    const Slot& entry = m_Index[slot];
+    if (entry.index == 0) return NOT_FOUND;
+    if (entry.hash == key.hash() && m_Values[entry.index - 1].first == key) return entry.index - 1;
+  }
+}
+
+Value& Compound::append(Key key) {
+  uint32_t hash = key.hash();
+  m_Values.emplace_back(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple());
+  indexEntry(m_Values.size() - 1, hash);
+  return m_Values.back().second;
+}
+
+void Compound::indexEntry(size_t index, uint32_t hash) {
+  if (m_Values.size() <= COMPOUND_INDEX_THRESHOLD) return;
+  if (m_Index.size() < m_Values.size() * 2) {  // Keeps the load factor at or below 0.5
+    rebuildIndex();
+    return;
+  }
+
+  size_t mask = m_Index.size() - 1;
+  size_t slot = hash & mask;
+  while (m_Index[slot].index != 0) slot = (slot + 1) & mask;
+  m_Index[slot] = {hash, static_cast<uint32_t>(index + 1)};
+}
+
+void Compound::unindexEntry(size_t index, uint32_t hash) {
+  size_t mask = m_Index.size() - 1;
+  size_t slot = hash & mask;
+  while (m_Index[slot].index != index + 1) slot = (slot + 1) & mask;
+
+  // Backward-shift deletion: entries probed past the freed slot move back into it, so no tombstones are needed
+  for (size_t next = (slot + 1) & mask; m_Index[next].index != 0; next = (next + 1) & mask) {
+    size_t home = m_Index[next].hash & mask;
+    bool reachable = slot <= next ? (slot < home && home <= next) : (slot < home || home <= next);
+    if (reachable) continue;  // Its probe starts after the freed slot
+    m_Index[slot] = m_Index[next];
+    slot = next;
+  }
+  m_Index[slot] = {0, 0};
+
+  if (index == m_Values.size()) return;  // The last entry was removed, no other entry moved
+  for (auto& entry : m_Index) {
+    if (entry.index > index + 1) entry.index--;
+  }
+}
+
+void Compound::rebuildIndex() {
+  m_Index.clear();
+  if (m_Values.size() <= COMPOUND_INDEX_THRESHOLD) return;
+
+  size_t capacity = COMPOUND_INDEX_THRESHOLD * 4;
+  while (capacity < m_Values.size() * 4) capacity *= 2;
+  m_Index.resize(capacity, Slot{0, 0});
+
+  size_t mask = capacity - 1;
+  for (size_t i = 0; i < m_Values.size(); i++) {
+    uint32_t hash = m_Values[i].first.hash();
+    size_t slot = hash & mask;
+    while (m_Index[slot].index != 0) slot = (slot + 1) & mask;
+    m_Index[slot] = {hash, static_cast<uint32_t>(i + 1)};
+  }
+}
+
 Compound::Iterator Compound::begin() {
   return m_Values.begin();
 }
@@ -391,55 +676,307 @@ size_t Compound::size() const {
   return m_Values.size();
 }
 
-List::List(Type type) : m_Type(type) {
+std::pmr::memory_resource* Compound::getResource() const {
+  return m_Values.get_allocator().resource();
+}
+
+bool isPrimitive(Type type) {
+  return type >= Type::BYTE && type <= Type::DOUBLE;
+}
+
+template<typename T>
+constexpr Type elementType() {
+  if constexpr (std::is_same_v<T, int8_t>) return Type::BYTE;
+  else if constexpr (std::is_same_v<T, int16_t>) return Type::SHORT;
+  else if constexpr (std::is_same_v<T, int32_t>) return Type::INT;
+  else if constexpr (std::is_same_v<T, int64_t>) return Type::LONG;
+  else if constexpr (std::is_same_v<T, float>) return Type::FLOAT;
+  else return Type::DOUBLE;
+}
+
+template<typename T>
+T valueAs(const Value& value) {
+  if constexpr (std::is_same_v<T, int8_t>) return value.getByte();
+  else if constexpr (std::is_same_v<T, int16_t>) return value.getShort();
+  else if constexpr (std::is_same_v<T, int32_t>) return value.getInt();
+  else if constexpr (std::is_same_v<T, int64_t>) return value.getLong();
+  else if constexpr (std::is_same_v<T, float>) return value.getFloat();
+  else return value.getDouble();
+}
+
+template<typename Storage>
+Storage createStorage(Type type, std::pmr::memory_resource* resource) {
+  switch (type) {
+    case Type::BYTE: return Storage(std::in_place_index<1>, resource);
+    case Type::SHORT: return Storage(std::in_place_index<2>, resource);
+    case Type::INT: return Storage(std::in_place_index<3>, resource);
+    case Type::LONG: return Storage(std::in_place_index<4>, resource);
+    case Type::FLOAT: return Storage(std::in_place_index<5>, resource);
+    case Type::DOUBLE: return Storage(std::in_place_index<6>, resource);
+    default: return Storage(std::in_place_index<0>, resource);
+  }
+}
+
+List::List(Type type) : List(type, std::pmr::get_default_resource()) {
 
 }
 
+List::List(Type type, std::pmr::memory_resource* resource) : m_Type(type), m_Storage(createStorage<Storage>(type, resource)), m_Cache(nullptr) {
+
+}
+
+List::List(const List& rhs) : m_Type(rhs.m_Type), m_Storage(rhs.m_Storage), m_Cache(nullptr) {
+
+}
+
+List::List(List&& rhs) noexcept : m_Type(rhs.m_Type), m_Storage(std::move(rhs.m_Storage)), m_Cache(rhs.m_Cache.exchange(nullptr)) {
+
+}
+
+List::~List() {
+  clearCache();
+}
+
+List& List::operator=(const List& rhs) {
+  if (this == &rhs) return *this;
+  clearCache();
+  m_Type = rhs.m_Type;
+  m_Storage = rhs.m_Storage;
+  return *this;
+}
+
+List& List::operator=(List&& rhs) noexcept {
+  if (this == &rhs) return *this;
+  clearCache();
+  m_Type = rhs.m_Type;
+  m_Storage = std::move(rhs.m_Storage);
+  m_Cache = rhs.m_Cache.exchange(nullptr);
+  return *this;
+}
+
 bool List::operator==(const List& rhs) const {
   if (this == &rhs) return true;
-  // Deep Comparison
-  return m_Values == rhs.m_Values;
+  if (m_Storage.index() == rhs.m_Storage.index()) return m_Storage == rhs.m_Storage;  // Deep Comparison
+
+  if (size() != rhs.size()) return false;
+  for (size_t i = 0; i < size(); i++) {
+    if (!(element(i) == rhs.element(i))) return false;
+  }
+  return true;
 }
 
 Value& List::operator[](size_t index) {
-  return m_Values[index];
+  box();
+  return std::get<0>(m_Storage)[index];
 }
 
 const Value& List::operator[](size_t index) const {
-  return m_Values[index];
+  return boxed()[index];
 }
 
 void List::pushBack(Value value) {
-  m_Values.emplace_back(std::move(value));
+  clearCache();
+  std::visit([&](auto& values) {
+    using T = typename std::decay_t<decltype(values)>::value_type;
+    if constexpr (std::is_same_v<T, Value>) {
+      values.emplace_back(std::move(value));
+    } else {
+      if (value.getType() != m_Type) throw std::runtime_error("element type does not match list type");
+      values.push_back(valueAs<T>(value));
+    }
+  }, m_Storage);
+}
+
+void List::splice(size_t offset, size_t count, const List& elements) {
+  if (offset > size() || count > size() - offset) throw std::runtime_error("list splice out of range");
+  if (elements.size() != 0 && elements.m_Type != m_Type) throw std::runtime_error("element type does not match list type");
+  clearCache();
+
+  if (m_Storage.index() != elements.m_Storage.index()) box();  // Mixed storage is spliced as Values
+  std::visit([&](auto& values) {
+    using Values = std::decay_t<decltype(values)>;
+    auto position = values.erase(values.begin() + offset, values.begin() + offset + count);
+    if (const auto* inserted = std::get_if<Values>(&elements.m_Storage)) {
+      values.insert(position, inserted->begin(), inserted->end());
+    } else if constexpr (std::is_same_v<typename Values::value_type, Value>) {
+      values.insert(position, elements.begin(), elements.end());
+    }
+  }, m_Storage);
 }
 
 List::Iterator List::begin() {
-  return m_Values.begin();
+  box();
+  return std::get<0>(m_Storage).begin();
 }
 
 List::ConstIterator List::begin() const {
-  return m_Values.begin();
+  return boxed().begin();
 }
 
 List::Iterator List::end() {
-  return m_Values.end();
+  box();
+  return std::get<0>(m_Storage).end();
 }
 
 List::ConstIterator List::end() const {
-  return m_Values.end();
+  return boxed().end();
+}
+
+ByteArray& List::getBytes() {
+  return unboxed<int8_t>();
+}
+
+const ByteArray& List::getBytes() const {
+  return unboxed<int8_t>();
+}
+
+std::pmr::vector<int16_t>& List::getShorts() {
+  return unboxed<int16_t>();
+}
+
+const std::pmr::vector<int16_t>& List::getShorts() const {
+  return unboxed<int16_t>();
+}
+
+IntArray& List::getInts() {
+  return unboxed<int32_t>();
+}
+
+const IntArray& List::getInts() const {
+  return unboxed<int32_t>();
+}
+
+LongArray& List::getLongs() {
+  return unboxed<int64_t>();
+}
+
+const LongArray& List::getLongs() const {
+  return unboxed<int64_t>();
+}
+
+std::pmr::vector<float>& List::getFloats() {
+  return unboxed<float>();
+}
+
+const std::pmr::vector<float>& List::getFloats() const {
+  return unboxed<float>();
+}
+
+std::pmr::vector<double>& List::getDoubles() {
+  return unboxed<double>();
+}
+
+const std::pmr::vector<double>& List::getDoubles() const {
+  return unboxed<double>();
+}
+
+template<typename T>
+std::pmr::vector<T>& List::unboxed() {
+  clearCache();
+  if (auto* values = std::get_if<std::pmr::vector<T>>(&m_Storage)) return *values;
+  if (m_Type != elementType<T>()) throw std::runtime_error("list type does not match requested type");
+
+  const auto& boxedValues = std::get<0>(m_Storage);
+  std::pmr::vector<T> values(boxedValues.get_allocator().resource());
+  values.reserve(boxedValues.size());
+  for (const auto& value : boxedValues) {
+    values.push_back(valueAs<T>(value));
+  }
+  return m_Storage.template emplace<std::pmr::vector<T>>(std::move(values));
+}
+
+template<typename T>
+const std::pmr::vector<T>& List::unboxed() const {
+  if (auto* values = std::get_if<std::pmr::vector<T>>(&m_Storage)) return *values;
+  if (m_Storage.index() == 0 && isPrimitive(m_Type)) throw std::runtime_error("list elements are boxed, use the mutable accessor");
+  throw std::runtime_error("list type does not match requested type");
+}
+
+void List::box() {
+  if (m_Storage.index() == 0) return;
+  clearCache();
+
+  std::pmr::vector<Value> values(getResource());
+  values.reserve(size());
+  std::visit([&](const auto& typed) {
+    if constexpr (!std::is_same_v<typename std::decay_t<decltype(typed)>::value_type, Value>) {
+      for (auto element : typed) values.emplace_back(element);
+    }
+  }, m_Storage);
+  m_Storage.emplace<0>(std::move(values));
+}
+
+const std::pmr::vector<Value>& List::boxed() const {
+  if (m_Storage.index() == 0) return std::get<0>(m_Storage);
+
+  std::pmr::vector<Value>* cache = m_Cache.load(std::memory_order_acquire);
+  if (cache != nullptr) return *cache;
+
+  std::pmr::polymorphic_allocator<std::pmr::vector<Value>> allocator(getResource());
+  std::pmr::vector<Value>* values = allocator.allocate(1);
+  allocator.construct(values);  // Uses-allocator construction places the elements in the same resource
+  values->reserve(size());
+  std::visit([&](const auto& typed) {
+    if constexpr (!std::is_same_v<typename std::decay_t<decltype(typed)>::value_type, Value>) {
+      for (auto element : typed) values->emplace_back(element);
+    }
+  }, m_Storage);
+
+  if (m_Cache.compare_exchange_strong(cache, values, std::memory_order_acq_rel)) return *values;
+
+  values->~vector();  // Another thread installed its copy first
+  allocator.deallocate(values, 1);
+  return *cache;
+}
+
+Value List::element(size_t index) const {
+  return std::visit([&](const auto& values) { return Value(values[index]); }, m_Storage);
+}
+
+void List::clearCache() {
+  std::pmr::vector<Value>* cache = m_Cache.exchange(nullptr, std::memory_order_acq_rel);
+  if (cache == nullptr) return;
+
+  std::pmr::polymorphic_allocator<std::pmr::vector<Value>> allocator(cache->get_allocator().resource());
+  cache->~vector();
+  allocator.deallocate(cache, 1);
+}
+
+bool List::hasTypedStorage() const {
+  return m_Storage.index() != 0;
 }
 
 size_t List::size() const {
-  return m_Values.size();
+  return std::visit([](const auto& values) { return values.size(); }, m_Storage);
+}
+
+List List::share() const {
+  List list(m_Type, getResource());
+  std::visit([&](const auto& values) {
+    using Values = std::decay_t<decltype(values)>;
+    if constexpr (std::is_same_v<Values, std::pmr::vector<Value>>) {
+      auto& shared = list.m_Storage.emplace<Values>(getResource());
+      shared.reserve(values.size());
+      for (const auto& value : values) shared.push_back(value.share());
+    } else {
+      list.m_Storage.emplace<Values>(values, getResource());
+    }
+  }, m_Storage);
+  return list;
 }
 
 void List::setType(Type type) {
+  clearCache();
+  m_Storage = createStorage<Storage>(type, getResource());
   m_Type = type;
-  m_Values.clear();
 }
 
 Type List::getType() const {
   return m_Type;
 }
 
+std::pmr::memory_resource* List::getResource() const {
+  return std::visit([](const auto& values) { return values.get_allocator().resource(); }, m_Storage);
+}
+
 } // namespace nbt
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include "nbt/nbt_view.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include "buffer_input.hpp"
+#include "modified_utf.hpp"
+#include "primitive.hpp"
+
+namespace nbt {
+
+template<Type TYPE>
+inline void typeCheck(Type type) {
+  if (type != TYPE) {
+    throw std::runtime_error("object type does not match requested type");
+  }
+}
+
+template<typename T>
+ArrayView<T> arrayView(const char* data, const char* end) {
+  BufferInput in(data, end);
+  auto length = in.readPrimitive<int32_t>();
+  if (length < 0) throw std::runtime_error("negative nbt array length");
+  return {in.consume(static_cast<size_t>(length) * sizeof(T)), static_cast<size_t>(length)};
+}
+
+int8_t View::getByte() const {
+  typeCheck<Type::BYTE>(m_Type);
+  return Primitive<int8_t>::load(m_Data);
+}
+
+int16_t View::getShort() const {
+  typeCheck<Type::SHORT>(m_Type);
+  return Primitive<int16_t>::load(m_Data);
+}
+
+int32_t View::getInt() const {
+  typeCheck<Type::INT>(m_Type);
+  return Primitive<int32_t>::load(m_Data);
+}
+
+int64_t View::getLong() const {
+  typeCheck<Type::LONG>(m_Type);
+  return Primitive<int64_t>::load(m_Data);
+}
+
+float View::getFloat() const {
+  typeCheck<Type::FLOAT>(m_Type);
+  return Primitive<float>::load(m_Data);
+}
+
+double View::getDouble() const {
+  typeCheck<Type::DOUBLE>(m_Type);
+  return Primitive<double>::load(m_Data);
+}
+
+ArrayView<int8_t> View::getByteArray() const {
+  typeCheck<Type::BYTE_ARRAY>(m_Type);
+  return arrayView<int8_t>(m_Data, m_End);
+}
+
+ArrayView<int32_t> View::getIntArray() const {
+  typeCheck<Type::INT_ARRAY>(m_Type);
+  return arrayView<int32_t>(m_Data, m_End);
+}
+
+ArrayView<int64_t> View::getLongArray() const {
+  typeCheck<Type::LONG_ARRAY>(m_Type);
+  return arrayView<int64_t>(m_Data, m_End);
+}
+
+bool View::isAscii() const {
+  typeCheck<Type::STRING>(m_Type);
+  const char* begin = m_Data + Primitive<uint16_t>::getSize();
+  auto length = static_cast<size_t>(m_End - begin);
+  return utf::asciiPrefix<true>(begin, length) == length;
+}
+
+std::string_view View::getStringView() const {
+  if (!isAscii()) throw std::runtime_error("string is not ascii, use getString()");
+  return {m_Data + Primitive<uint16_t>::getSize(), size() - Primitive<uint16_t>::getSize()};
+}
+
+String View::getString(std::pmr::memory_resource* resource) const {
+  typeCheck<Type::STRING>(m_Type);
+  String string(resource);
+  utf::decodeUTF(m_Data + Primitive<uint16_t>::getSize(), static_cast<uint16_t>(size() - Primitive<uint16_t>::getSize()), string);
+  return string;
+}
+
+CompoundView View::getCompound() const {
+  typeCheck<Type::COMPOUND>(m_Type);
+  return {m_Data, m_End};
+}
+
+ListView View::getList() const {
+  typeCheck<Type::LIST>(m_Type);
+  BufferInput in(m_Data, m_End);
+  Type elementType = in.readType();
+  auto length = in.readPrimitive<int32_t>();
+  if (elementType == static_cast<Type>(0) || length < 0) length = 0;
+  return {elementType, static_cast<size_t>(length), in.position(), m_End};
+}
+
+CompoundView::Iterator::Iterator(const char* position, const char* end) : m_Next(position), m_End(end) {
+  operator++();
+}
+
+CompoundView::Iterator& CompoundView::Iterator::operator++() {
+  if (m_Next == m_End || *m_Next == 0) {  // End of buffer or TAG_End
+    m_Next = nullptr;
+    return *this;
+  }
+
+  BufferInput in(m_Next, m_End);
+  Type type = in.readType();
+  auto nameLength = in.readPrimitive<uint16_t>();
+  const char* name = in.consume(nameLength);
+  const char* payload = in.position();
+  skipPayload(in, type);
+
+  m_Entry.name = std::string_view(name, nameLength);
+  m_Entry.value = View(type, payload, in.position());
+  m_Next = in.position();
+  return *this;
+}
+
+View CompoundView::get(std::string_view key) const {
+  // Names are matched as stored, and as modified UTF-8, which only differs from key past its ASCII prefix. Encoding at
+  // most doubles a key's length, keys that could overflow a name's length prefix are only matched as stored.
+  std::string encoded;
+  std::string_view modified = key;
+  if (utf::asciiPrefix<false>(key.data(), key.size()) != key.size() && key.size() <= UINT16_MAX / 2) {
+    encoded.resize(utf::getByteLength(key));
+    utf::encodeUTF(encoded.data(), key);
+    modified = std::string_view(encoded).substr(Primitive<uint16_t>::getSize());
+  }
+
+  for (const auto& entry : *this) {
+    if (entry.name == key || entry.name == modified) return entry.value;
+  }
+  return {};
+}
+
+bool CompoundView::hasKey(std::string_view key) const {
+  return static_cast<bool>(get(key));
+}
+
+CompoundView::Iterator CompoundView::begin() const {
+  return {m_Data, m_End};
+}
+
+CompoundView::Iterator CompoundView::end() const {
+  return {};
+}
+
+size_t CompoundView::size() const {
+  size_t size = 0;
+  for (auto it = begin(); it != end(); ++it) size++;
+  return size;
+}
+
+ListView::Iterator::Iterator(Type type, const char* position, const char* end, size_t remaining) : m_Value(type, position, position), m_Next(position), m_End(end), m_Remaining(remaining + 1) {
+  operator++();
+}
+
+ListView::Iterator& ListView::Iterator::operator++() {
+  if (--m_Remaining == 0) return *this;
+
+  BufferInput in(m_Next, m_End);
+  skipPayload(in, m_Value.getType());
+  m_Value = View(m_Value.getType(), m_Next, in.position());
+  m_Next = in.position();
+  return *this;
+}
+
+View ListView::operator[](size_t index) const {
+  if (index >= m_Size) throw std::out_of_range("list index out of range");
+
+  size_t elementSize = fixedPayloadSize(m_Type);
+  if (elementSize != 0) {
+    BufferInput in(m_Data, m_End);
+    in.consume(index * elementSize);
+    const char* element = in.consume(elementSize);
+    return {m_Type, element, in.position()};
+  }
+
+  auto it = begin();
+  std::advance(it, index);
+  return *it;
+}
+
+ListView::Iterator ListView::begin() const {
+  return {m_Type, m_Data, m_End, m_Size};
+}
+
+ListView::Iterator ListView::end() const {
+  return {};
+}
+
+} // namespace nbt
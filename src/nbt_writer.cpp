@@ -1,166 +1,115 @@
 #include "nbt/nbt_writer.hpp"
 
-#include "byteswap.hpp"
-#include "modified_utf.hpp"
+#include <stdexcept>
+
+#include "codec.hpp"
+#include "compression.hpp"
+#include "encoder.hpp"
 #include "nbt/nbt.hpp"
 
 namespace nbt {
 
-std::ostream& operator<<(std::ostream& out, Type type);
-std::ostream& operator<<(std::ostream& out, const std::string_view& string);
-std::ostream& operator<<(std::ostream& out, const Compound& compound);
-std::ostream& operator<<(std::ostream& out, const List& list);
-std::ostream& operator<<(std::ostream& out, const Value& value);
-
-size_t getCompoundSize(const Compound& compound);
-size_t getListSize(const List& list);
-size_t getValueSize(const Value& value);
+template<typename Codec>
+size_t getDocumentSize(const Compound& compound, const std::string_view& name) {
+  if constexpr (!Codec::NAMED_ROOT) return 1 + Encoder<Codec>::getSize(compound);
 
-void Writer::write(std::ostream& out, const Compound& compound, const std::string_view& name) {
+  size_t size = 1 + Encoder<Codec>::getNameSize(name) + Encoder<Codec>::getSize(compound);
   if constexpr (nbt::config::writeRootTag()) {  //NOLINT
-    out << Type::COMPOUND;
-    out << std::string_view("");
+    size += 1 + Encoder<Codec>::getNameSize("") + 1;  // Root compound header and its TAG_End
   }
-
-
-  out << Type::COMPOUND;
-  out << name;
-  out << compound;
-
-  out << static_cast<Type>(0);
+  return size;
 }
 
-class OutputVectorBuffer : public std::streambuf {
- public:
-  OutputVectorBuffer(size_t startingSize) : m_CurrentIndex(0) { m_Buffer.resize(startingSize); }
+template<typename Codec>
+void encodeDocument(char* out, const Compound& compound, const std::string_view& name) {
+  Encoder<Codec> encoder(out);
+  if constexpr (!Codec::NAMED_ROOT) {
+    encoder.writeType(Type::COMPOUND);
+    encoder.writeCompound(compound);
+    return;
+  }
 
-  std::vector<char> moveBuffer() && { 
-    m_Buffer.resize(m_CurrentIndex);
-    return std::move(m_Buffer);
+  if constexpr (nbt::config::writeRootTag()) {  //NOLINT
+    encoder.writeType(Type::COMPOUND);
+    encoder.writeName("");
   }
-  
- protected:
-  std::streamsize xsputn(const char* data, std::streamsize length) override {
-    if (m_Buffer.size() - m_CurrentIndex <= length) {
-      m_Buffer.resize(m_Buffer.size() * 2);
-    }
-    memcpy(m_Buffer.data() + m_CurrentIndex, data, length);
-    m_CurrentIndex += length;
-    return length;
+
+  encoder.writeType(Type::COMPOUND);
+  encoder.writeName(name);
+  encoder.writeCompound(compound);
+
+  if constexpr (nbt::config::writeRootTag()) {  //NOLINT
+    encoder.writeType(static_cast<Type>(0));
   }
- private:
-  std::vector<char> m_Buffer;
-  size_t m_CurrentIndex;
-};
-
-std::vector<char> Writer::writeToBuffer(const Compound& compound, const std::string_view& key) {
-  OutputVectorBuffer out(getCompoundSize(compound));
-  std::ostream stream(&out);
-  write(stream, compound, key);
-  out.pubsync();
-
-  return std::move(out).moveBuffer();
 }
 
-std::ostream& operator<<(std::ostream& out, Type type) {
-  out.write(reinterpret_cast<const char*>(&type), sizeof(type));
-  return out;
+template<typename Codec>
+void encodeToBuffer(const Compound& compound, std::vector<char>& buffer, const std::string_view& name) {
+  buffer.resize(getDocumentSize<Codec>(compound, name));
+  encodeDocument<Codec>(buffer.data(), compound, name);
 }
 
-std::ostream& operator<<(std::ostream& out, const std::string_view& string) {
-  Primitive<uint16_t>::writeTo(out, static_cast<uint16_t>(string.length()));
-  out.write(string.data(), static_cast<std::streamsize>(string.length()));
-  return out;
+size_t Writer::getEncodedSize(const Compound& compound, const std::string_view& name) {
+  return getDocumentSize<JavaCodec>(compound, name);
 }
 
-std::ostream& operator<<(std::ostream& out, const Compound& compound) {
-  for (const auto& pair : compound) {
-    if (pair.second.getType() == static_cast<Type>(0)) continue;  // NULL-Pair
-    out << pair.second.getType();
-    out << std::string_view(pair.first);
-    out << pair.second;
+size_t Writer::getEncodedSize(const Compound& compound, Format format, const std::string_view& name) {
+  switch (format) {
+    case Format::JAVA: return getDocumentSize<JavaCodec>(compound, name);
+    case Format::JAVA_NETWORK: return getDocumentSize<JavaNetworkCodec>(compound, name);
+    case Format::BEDROCK: return getDocumentSize<BedrockCodec>(compound, name);
+    case Format::BEDROCK_NETWORK: return getDocumentSize<BedrockNetworkCodec>(compound, name);
+    default: throw std::runtime_error("invalid nbt format");
   }
+}
 
-  Type type = static_cast<Type>(0); //TAG_END
-  out << type;
-
-  return out;
+void Writer::write(std::ostream& out, const Compound& compound, const std::string_view& name) {
+  std::vector<char> buffer = writeToBuffer(compound, name);
+  out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
 }
 
-std::ostream& operator<<(std::ostream& out, const List& list) {
-  out << list.getType();
-  Primitive<int32_t>::writeTo(out, static_cast<int32_t>(list.size()));
-  for (const auto& element : list) {
-    out << element;
-  }
-  return out;
+void Writer::write(std::ostream& out, const Compound& compound, Compression compression, const std::string_view& name) {
+  std::vector<char> buffer = writeToBuffer(compound, name);
+  deflateTo(out, buffer.data(), buffer.size(), compression);
 }
 
-std::ostream& operator<<(std::ostream& out, const Value& value) {
-  switch (value.getType()) {
-    case Type::BYTE:Primitive<int8_t>::writeTo(out, value.getByte());
-      break;
-    case Type::SHORT:Primitive<int16_t>::writeTo(out, value.getShort());
-      break;
-    case Type::INT:Primitive<int32_t>::writeTo(out, value.getInt());
-      break;
-    case Type::LONG:Primitive<int64_t>::writeTo(out, value.getLong());
-      break;
-    case Type::FLOAT:Primitive<float>::writeTo(out, value.getFloat());
-      break;
-    case Type::DOUBLE:Primitive<double>::writeTo(out, value.getDouble());
-      break;
-    case Type::BYTE_ARRAY:Array<int8_t>::writeTo(out, value.getByteArray().data(), value.getByteArray().size());
-      break;
-    case Type::STRING:utf::writeUTF(out, value.getString());
-      break;
-    case Type::LIST:out << value.getList();
-      break;
-    case Type::COMPOUND:out << value.getCompound();
-      break;
-    case Type::INT_ARRAY:Array<int32_t>::writeTo(out, value.getIntArray().data(), value.getIntArray().size());
-      break;
-    case Type::LONG_ARRAY:Array<int64_t>::writeTo(out, value.getLongArray().data(), value.getLongArray().size());
-      break;
-  }
-  return out;
+void Writer::write(std::ostream& out, const Compound& compound, Format format, const std::string_view& name) {
+  std::vector<char> buffer = writeToBuffer(compound, format, name);
+  out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
 }
 
-size_t getValueSize(const Value& value) {
-  switch (value.getType()) {
-    case Type::BYTE: return Primitive<int8_t>::getSize();
-    case Type::SHORT: return Primitive<int16_t>::getSize();
-    case Type::INT: return Primitive<int32_t>::getSize();
-    case Type::LONG: return Primitive<int64_t>::getSize();
-    case Type::FLOAT: return Primitive<float>::getSize();
-    case Type::DOUBLE: return Primitive<double>::getSize();
-    case Type::BYTE_ARRAY: return value.getByteArray().size() * Primitive<int8_t>::getSize();
-    case Type::INT_ARRAY: return value.getIntArray().size() * Primitive<int32_t>::getSize();
-    case Type::LONG_ARRAY: return value.getLongArray().size() * Primitive<int64_t>::getSize();
-    case Type::STRING: return utf::getByteLength(value.getString());
-    case Type::LIST: return getListSize(value.getList());
-    case Type::COMPOUND: return getCompoundSize(value.getCompound());
-    default:
-      throw std::runtime_error("invalid nbt type");
-  }
+std::vector<char> Writer::writeToBuffer(const Compound& compound, const std::string_view& name) {
+  std::vector<char> buffer;
+  writeToBuffer(compound, buffer, name);
+  return buffer;
 }
 
-size_t getCompoundSize(const Compound& compound) {
-  size_t totalSize = 0;
-  for (const auto& pair : compound) {
-    totalSize += getValueSize(pair.second);
-  }
+std::vector<char> Writer::writeToBuffer(const Compound& compound, Format format, const std::string_view& name) {
+  std::vector<char> buffer;
+  writeToBuffer(compound, buffer, format, name);
+  return buffer;
+}
 
-  return totalSize;
+void Writer::writeToBuffer(const Compound& compound, std::vector<char>& buffer, const std::string_view& name) {
+  encodeToBuffer<JavaCodec>(compound, buffer, name);
 }
 
-size_t getListSize(const List& list) {
-  size_t totalSize = 0;
-  for (const auto& element : list) {
-    totalSize += getValueSize(element);
+void Writer::writeToBuffer(const Compound& compound, std::vector<char>& buffer, Format format, const std::string_view& name) {
+  switch (format) {
+    case Format::JAVA: return encodeToBuffer<JavaCodec>(compound, buffer, name);
+    case Format::JAVA_NETWORK: return encodeToBuffer<JavaNetworkCodec>(compound, buffer, name);
+    case Format::BEDROCK: return encodeToBuffer<BedrockCodec>(compound, buffer, name);
+    case Format::BEDROCK_NETWORK: return encodeToBuffer<BedrockNetworkCodec>(compound, buffer, name);
+    default: throw std::runtime_error("invalid nbt format");
   }
+}
+
+size_t Writer::writeToBuffer(const Compound& compound, void* buffer, size_t capacity, const std::string_view& name) {
+  size_t size = getEncodedSize(compound, name);
+  if (size > capacity) throw std::runtime_error("buffer too small for encoded nbt");
 
-  return totalSize;
+  encodeDocument<JavaCodec>(reinterpret_cast<char*>(buffer), compound, name);
+  return size;
 }
 
-} // namespace nbt
\ No newline at end of file
+} // namespace nbt
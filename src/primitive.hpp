@@ -1,173 +1,180 @@
 #ifndef NBT_SRC_PRIMITIVE_HPP_
 #define NBT_SRC_PRIMITIVE_HPP_
 
+#include <algorithm>
 #include <cstddef>
-#include <functional>
-#include <istream>
-#include <ostream>
+#include <cstring>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "codec.hpp"
 
 namespace nbt {
 
-template<typename T>
+/**
+ * A fixed width or varint field, encoded as Codec prescribes (see codec.hpp).
+ */
+template<typename T, typename Codec = JavaCodec>
 class Primitive {
  public:
-  inline static void writeTo(std::ostream& out, T value);
-  inline static T readFrom(std::istream& in);
+  /**
+   * Whether values are varints: INT and LONG payloads and lengths, zig-zag encoded, and name and string lengths.
+   */
+  constexpr static bool VARINT = Codec::VARINTS && (std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> || std::is_same_v<T, uint16_t>);
+
+  /**
+   * Encodes a fixed width value at data, which must have room for getSize() bytes.
+   */
+  inline static void store(char* data, T value) {
+    Codec::ByteOrder::template store<T>(data, value);
+  }
+
+  /**
+   * Encodes value at out, which must have room for getSize(value) bytes.
+   * @return Returns the position after the encoded value.
+   */
+  inline static char* write(char* out, T value);
+
+  template<typename Input>
+  inline static T readFrom(Input& in);
+
+  /**
+   * Decodes a fixed width value stored at data, which must hold at least getSize() bytes.
+   */
+  inline static T load(const char* data) {
+    return Codec::ByteOrder::template load<T>(data);
+  }
 
   constexpr static size_t getSize() {
     return sizeof(T);
   }
+
+  /**
+   * @return Returns the encoded size of value.
+   */
+  inline static size_t getSize(T value);
 };
 
-template<typename T>
+template<typename T, typename Codec = JavaCodec>
 class Array {
  public:
-  inline static void writeTo(std::ostream& out, const T* values, size_t length);
-  inline static std::vector<T> readFrom(std::istream& in);
+  /**
+   * Encodes length elements, without a length prefix, at data.
+   * @return Returns the position after the encoded elements.
+   */
+  inline static char* storeElements(char* data, const T* values, size_t length);
+
+  template<typename Input>
+  inline static std::pmr::vector<T> readFrom(Input& in, std::pmr::memory_resource* resource);
+
+  /**
+   * Appends length elements, without a length prefix, to values.
+   */
+  template<typename Input>
+  inline static void readElements(Input& in, std::pmr::vector<T>& values, size_t length);
+
+  /**
+   * @return Returns the encoded size of the elements, without a length prefix.
+   */
+  inline static size_t getSize(const T* values, size_t length);
 };
 
-template<>
-inline void Primitive<int8_t>::writeTo(std::ostream& out, int8_t value) {
-  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
-}
-
-template<>
-inline int8_t Primitive<int8_t>::readFrom(std::istream& in) {
-  int8_t value;
-  in.read(reinterpret_cast<char*>(&value), getSize());
-  return value;
-}
-
-template<>
-inline void Primitive<int16_t>::writeTo(std::ostream& out, int16_t value) {
-  value = hostToNetwork16(value);
-  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
-}
-
-template<>
-inline int16_t Primitive<int16_t>::readFrom(std::istream& in) {
-  uint16_t value;
-  in.read(reinterpret_cast<char*>(&value), getSize());
-  return static_cast<int16_t>(hostToNetwork16(value));
-}
-
-template<>
-inline void Primitive<int32_t>::writeTo(std::ostream& out, int32_t value) {
-  value = hostToNetwork32(value);
-  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
-}
-
-template<>
-inline int32_t Primitive<int32_t>::readFrom(std::istream& in) {
-  uint32_t value;
-  in.read(reinterpret_cast<char*>(&value), getSize());
-  return static_cast<int32_t>(hostToNetwork32(value));
-}
-
-template<>
-inline void Primitive<int64_t>::writeTo(std::ostream& out, int64_t value) {
-  value = hostToNetwork64(value);
-  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
-}
-
-template<>
-inline int64_t Primitive<int64_t>::readFrom(std::istream& in) {
-  uint64_t value;
-  in.read(reinterpret_cast<char*>(&value), getSize());
-  return static_cast<int64_t>(hostToNetwork64(value));}
-
-template<>
-inline void Primitive<float>::writeTo(std::ostream& out, float value) {
-  uint32_t intBits = hostToNetwork32(*reinterpret_cast<const uint32_t*>(&value));
-  out.write(reinterpret_cast<const char*>(&intBits), sizeof(intBits));
-}
-
-template<>
-inline float Primitive<float>::readFrom(std::istream& in) {
-  uint32_t intBits;
-  in.read(reinterpret_cast<char*>(&intBits), getSize());
-  intBits = hostToNetwork32(intBits);
-  return *reinterpret_cast<const float*>(&intBits);
-}
-
-template<>
-inline void Primitive<double>::writeTo(std::ostream& out, double value) {
-  uint64_t intBits = hostToNetwork64(*reinterpret_cast<const uint64_t*>(&value));
-  out.write(reinterpret_cast<const char*>(&intBits), sizeof(intBits));
-}
-
-template<>
-inline double Primitive<double>::readFrom(std::istream& in) {
-  uint64_t intBits;
-  in.read(reinterpret_cast<char*>(&intBits), getSize());
-  intBits = hostToNetwork64(intBits);
-  return *reinterpret_cast<const double*>(&intBits);
-}
-
-template<> inline void Primitive<uint16_t>::writeTo(std::ostream& out, uint16_t value) {
-  value = hostToNetwork16(*reinterpret_cast<const uint16_t*>(&value));
-  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
-}
-
-template<>
-inline uint16_t Primitive<uint16_t>::readFrom(std::istream& in) {
-  uint16_t value;
-  in.read(reinterpret_cast<char*>(&value), getSize());
-  return hostToNetwork16(value);
-}
-
-template<>
-inline void Array<int8_t>::writeTo(std::ostream& out, const int8_t* values, size_t length) {
-  Primitive<int32_t>::writeTo(out, static_cast<int32_t>(length));
-  out.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(length));
+template<typename T, typename Codec>
+inline char* Primitive<T, Codec>::write(char* out, T value) {
+  if constexpr (VARINT && std::is_same_v<T, uint16_t>) {
+    return storeVarint(out, value);
+  } else if constexpr (VARINT) {
+    return storeVarint(out, zigZagEncode(value));
+  } else {
+    store(out, value);
+    return out + sizeof(T);
+  }
 }
 
-template<>
-inline std::vector<int8_t> Array<int8_t>::readFrom(std::istream& in) {
-  int32_t size = Primitive<int32_t>::readFrom(in);
-  std::vector<int8_t> vector(size);
-  in.read(reinterpret_cast<char*>(vector.data()), static_cast<std::streamsize>(vector.size()));
-  return std::move(vector);
+template<typename T, typename Codec>
+template<typename Input>
+inline T Primitive<T, Codec>::readFrom(Input& in) {
+  if constexpr (VARINT && std::is_same_v<T, uint16_t>) {
+    uint64_t value = readVarint(in, 5);
+    if (value > UINT16_MAX) throw std::runtime_error("nbt string too long");
+    return static_cast<T>(value);
+  } else if constexpr (VARINT) {
+    return static_cast<T>(zigZagDecode(readVarint(in, sizeof(T) == 4 ? 5 : 10)));
+  } else {
+    return in.template readPrimitive<T, Codec>();
+  }
 }
 
-template<>
-inline void Array<int32_t>::writeTo(std::ostream& out, const int* values, size_t length) {
-  Primitive<int32_t>::writeTo(out, static_cast<int32_t>(length));
-
-  for (size_t i = 0; i < length; i++) {
-    Primitive<int32_t>::writeTo(out, values[i]);
+template<typename T, typename Codec>
+inline size_t Primitive<T, Codec>::getSize(T value) {
+  if constexpr (VARINT && std::is_same_v<T, uint16_t>) {
+    return getVarintSize(value);
+  } else if constexpr (VARINT) {
+    return getVarintSize(zigZagEncode(value));
+  } else {
+    return sizeof(T);
   }
 }
 
-template<>
-inline std::vector<int32_t> Array<int32_t>::readFrom(std::istream& in) {
-  int32_t size = Primitive<int32_t>::readFrom(in);
-  std::vector<int32_t> vector(size);
-  for (int & i : vector) {
-    i = Primitive<int32_t>::readFrom(in);
+template<typename T, typename Codec>
+inline char* Array<T, Codec>::storeElements(char* data, const T* values, size_t length) {
+  if constexpr (Primitive<T, Codec>::VARINT) {
+    for (size_t i = 0; i < length; i++) data = Primitive<T, Codec>::write(data, values[i]);
+    return data;
+  } else {
+    Codec::ByteOrder::convert(reinterpret_cast<T*>(data), values, length);  // The bulk swaps accept unaligned pointers
+    return data + length * sizeof(T);
   }
-  return std::move(vector);
 }
 
-template<>
-inline void Array<int64_t>::writeTo(std::ostream& out, const int64_t* values, size_t length) {
-  Primitive<int64_t>::writeTo(out, static_cast<int32_t>(length));
-
-  for (size_t i = 0; i < length; i++) {
-    Primitive<int64_t>::writeTo(out, values[i]);
+template<typename T, typename Codec>
+template<typename Input>
+inline std::pmr::vector<T> Array<T, Codec>::readFrom(Input& in, std::pmr::memory_resource* resource) {
+  int32_t size = Primitive<int32_t, Codec>::readFrom(in);
+  if (size < 0) throw std::runtime_error("negative nbt array length");
+
+  std::pmr::vector<T> vector(resource);
+  readElements(in, vector, static_cast<size_t>(size));
+  return vector;
+}
+
+template<typename T, typename Codec>
+template<typename Input>
+inline void Array<T, Codec>::readElements(Input& in, std::pmr::vector<T>& values, size_t length) {
+  // Lengths from unbounded inputs are unverified until the elements arrive, so storage grows with the data read
+  constexpr size_t STEP = Input::BOUNDED ? SIZE_MAX : (1 << 20) / sizeof(T);
+
+  if constexpr (Primitive<T, Codec>::VARINT) {
+    in.require(length);  // At least one byte per element
+    values.reserve(values.size() + std::min(length, STEP));
+    for (size_t i = 0; i < length; i++) values.push_back(Primitive<T, Codec>::readFrom(in));
+  } else {
+    in.require(length * sizeof(T));
+    while (length != 0) {
+      size_t count = std::min(length, STEP);
+      size_t offset = values.size();
+      values.resize(offset + count);
+      T* destination = values.data() + offset;
+      in.read(reinterpret_cast<char*>(destination), count * sizeof(T));
+      Codec::ByteOrder::convert(destination, destination, count);
+      length -= count;
+    }
   }
 }
 
-template<>
-inline std::vector<int64_t> Array<int64_t>::readFrom(std::istream& in) {
-  int32_t size = Primitive<int32_t>::readFrom(in);
-  std::vector<int64_t> vector(size);
-  for (int64_t& i : vector) {
-    i = Primitive<int64_t>::readFrom(in);
+template<typename T, typename Codec>
+inline size_t Array<T, Codec>::getSize(const T* values, size_t length) {
+  if constexpr (Primitive<T, Codec>::VARINT) {
+    size_t size = 0;
+    for (size_t i = 0; i < length; i++) size += Primitive<T, Codec>::getSize(values[i]);
+    return size;
+  } else {
+    return length * sizeof(T);
   }
-  return std::move(vector);
 }
 
-}
+} // namespace nbt
 
 #endif //NBT_SRC_PRIMITIVE_HPP_
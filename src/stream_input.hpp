@@ -0,0 +1,57 @@
+#ifndef NBT_SRC_STREAM_INPUT_HPP_
+#define NBT_SRC_STREAM_INPUT_HPP_
+
+#include <cstddef>
+#include <istream>
+#include <stdexcept>
+
+#include "nbt/nbt_type.hpp"
+#include "primitive.hpp"
+
+namespace nbt {
+
+/**
+ * Adapts a std::istream to the input interface of BufferInput.
+ */
+class StreamInput {
+ public:
+  static constexpr bool BOUNDED = false;
+
+  explicit StreamInput(std::istream& in) : m_Stream(in) {}
+
+  void read(char* destination, size_t length) {
+    m_Stream.read(destination, static_cast<std::streamsize>(length));
+    if (static_cast<size_t>(m_Stream.gcount()) != length) throw std::runtime_error("unexpected end of nbt data");
+  }
+
+  void skip(size_t length) {
+    m_Stream.ignore(static_cast<std::streamsize>(length));
+    if (static_cast<size_t>(m_Stream.gcount()) != length) throw std::runtime_error("unexpected end of nbt data");
+  }
+
+  /**
+   * Streams cannot report the remaining length up front, short reads are detected by read() instead.
+   */
+  void require(size_t) const {}
+
+  template<typename T, typename Codec = JavaCodec>
+  T readPrimitive() {
+    char bytes[Primitive<T, Codec>::getSize()];
+    read(bytes, sizeof(bytes));
+    return Primitive<T, Codec>::load(bytes);
+  }
+
+  Type readType() {
+    return static_cast<Type>(readPrimitive<int8_t>());
+  }
+
+  int peek() {
+    return m_Stream.peek();
+  }
+ private:
+  std::istream& m_Stream;
+};
+
+} // namespace nbt
+
+#endif //NBT_SRC_STREAM_INPUT_HPP_
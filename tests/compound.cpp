@@ -0,0 +1,173 @@
+#include <limits>
+#include <thread>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "test.hpp"
+
+TEST(Nbt, CompoundOrder) { //NOLINT
+  std::vector<char> binary = readTestCompound();
+  nbt::Compound document = nbt::Reader::parse(binary.data(), binary.size());
+  auto buffer = nbt::Writer::writeToBuffer(document["Level"].getCompound(), "Level");
+
+  // Insertion order is kept, so re-encoding reproduces the original bytes.
+  EXPECT_EQ(buffer, binary);
+}
+
+TEST(Nbt, CompoundIndex) { //NOLINT
+  nbt::Compound compound;
+  for (int32_t i = 0; i < 1000; i++) {
+    compound.insert("key" + std::to_string(i), i);
+  }
+  compound["key500"] = static_cast<int32_t>(-1);
+
+  ASSERT_EQ(compound.size(), 1000);
+  EXPECT_EQ(compound.get("key999")->getInt(), 999);
+  EXPECT_EQ(compound.get("key500")->getInt(), -1);
+  EXPECT_EQ(compound.get("key1000"), nullptr);
+
+  for (int32_t i = 0; i < 1000; i += 2) {
+    EXPECT_TRUE(compound.remove("key" + std::to_string(i)));
+  }
+  ASSERT_EQ(compound.size(), 500);
+  EXPECT_FALSE(compound.hasKey("key998"));
+  EXPECT_EQ(compound.get("key997")->getInt(), 997);
+
+  int32_t expected = 1;
+  for (const auto& pair : compound) {
+    EXPECT_EQ(std::string_view(pair.first), "key" + std::to_string(expected));
+    expected += 2;
+  }
+
+  // Removals from either end keep the index consistent with the remaining entries
+  for (int32_t i = 999; i >= 501; i -= 2) {
+    EXPECT_TRUE(compound.remove("key" + std::to_string(i)));
+    EXPECT_TRUE(compound.remove("key" + std::to_string(i - 500)));
+  }
+  ASSERT_EQ(compound.size(), 0);
+  for (int32_t i = 0; i < 100; i++) compound.insert("key" + std::to_string(i), i);
+  for (int32_t i = 0; i < 90; i++) EXPECT_TRUE(compound.remove("key" + std::to_string(i * 7 % 100)));
+  ASSERT_EQ(compound.size(), 10);
+  for (int32_t i = 0; i < 100; i++) {
+    int32_t key = i * 7 % 100;
+    if (i < 90) {
+      EXPECT_FALSE(compound.hasKey("key" + std::to_string(key)));
+    } else {
+      EXPECT_EQ(compound.get("key" + std::to_string(key))->getInt(), key);
+    }
+  }
+  compound.clear();
+  EXPECT_EQ(compound.size(), 0);
+  EXPECT_EQ(compound.get("key1"), nullptr);
+}
+
+TEST(Nbt, CompoundKeyTable) { //NOLINT
+  std::vector<char> binary = readTestCompound();
+  nbt::KeyTable keys;
+  nbt::ReaderOptions options;
+  options.keyTable = &keys;
+
+  nbt::Compound first = nbt::Reader::parse(binary.data(), binary.size(), options);
+  nbt::Compound second = nbt::Reader::parse(binary.data(), binary.size(), options);
+  EXPECT_TRUE(first == nbt::Reader::parse(binary.data(), binary.size()));
+  EXPECT_TRUE(first["Level"].getCompound() == createTestCompound());
+
+  // Both documents share the table's atoms.
+  size_t interned = keys.size();
+  const auto& level = first["Level"].getCompound();
+  auto other = second["Level"].getCompound().begin();
+  for (const auto& pair : level) {
+    EXPECT_TRUE(pair.first.isInterned());
+    EXPECT_EQ(pair.first.data(), (other++)->first.data());
+  }
+  EXPECT_EQ(keys.intern("Level").data(), first.begin()->first.data());
+  EXPECT_EQ(keys.size(), interned);
+
+  nbt::Key global = nbt::KeyTable::global().intern("a key longer than the inline capacity");
+  EXPECT_EQ(global, nbt::Key("a key longer than the inline capacity"));
+  EXPECT_EQ(global.data(), nbt::KeyTable::global().intern(global).data());
+  EXPECT_FALSE(nbt::Key("short").isInterned());
+}
+
+TEST(Nbt, CompoundValue) { //NOLINT
+  std::pmr::monotonic_buffer_resource resource;
+  nbt::Compound compound(&resource);
+  compound["name"] = nbt::String("a string too long to be stored inline", &resource);
+  compound["nested"] = nbt::Compound(&resource);
+  compound["nested"].getCompound()["byte"] = static_cast<int8_t>(7);
+
+  // Boxed payloads live in their own resource and move with the Value
+  EXPECT_EQ(compound["name"].getString().get_allocator().resource(), &resource);
+  nbt::Value moved = std::move(compound["nested"]);
+  EXPECT_EQ(moved.getCompound().get("byte")->getByte(), 7);
+  EXPECT_EQ(moved.getCompound().getResource(), &resource);
+
+  // A value may be replaced by one of its own descendants
+  nbt::Value value = nbt::Compound();
+  value.getCompound()["child"] = nbt::List(nbt::Type::STRING);
+  value.getCompound()["child"].getList().pushBack("element");
+  value = std::move(value.getCompound()["child"]);
+  EXPECT_EQ(value.getList()[0].getString(), "element");
+
+  value = value.getList()[0];
+  EXPECT_EQ(value.getString(), "element");
+}
+
+TEST(Nbt, CompoundShare) { //NOLINT
+  nbt::Value original = createTestCompound();
+  const nbt::Value& constOriginal = original;
+  nbt::Value snapshot = original.share();
+  const nbt::Value& constSnapshot = snapshot;
+  EXPECT_TRUE(snapshot == original);
+  EXPECT_EQ(&constSnapshot.getCompound(), &constOriginal.getCompound());
+
+  // Only the path to the modified tag is cloned, its siblings stay shared
+  original.getCompound()["nested compound test"].getCompound()["egg"].getCompound()["value"] = 1.0F;
+  EXPECT_EQ(snapshot.getCompound().get("nested compound test")->getCompound().get("egg")->getCompound().get("value")->getFloat(), 0.5F);
+  EXPECT_FALSE(snapshot == original);
+
+  const nbt::Compound& sharedNested = constSnapshot.getCompound().get("nested compound test")->getCompound();
+  const nbt::Compound& ownNested = constOriginal.getCompound().get("nested compound test")->getCompound();
+  EXPECT_NE(&sharedNested, &ownNested);
+  EXPECT_EQ(&sharedNested.get("ham")->getCompound(), &ownNested.get("ham")->getCompound());
+  EXPECT_EQ(&constSnapshot.getCompound().get("listTest (compound)")->getList(), &constOriginal.getCompound().get("listTest (compound)")->getList());
+
+  // Compounds and lists share their children
+  nbt::Compound compound = createTestCompound();
+  nbt::Compound copy = compound.share();
+  copy["listTest (compound)"].getList()[0].getCompound()["name"] = "renamed";
+  copy["byteArrayTest (the first 1000 values of (n*n*255+n*7)%100, starting with n=0 (0, 62, 34, 16, 8, ...))"].getByteArray()[0] = 1;
+  EXPECT_TRUE(compound == createTestCompound());
+  EXPECT_EQ(copy["listTest (compound)"].getList()[0].getCompound()["name"].getString(), "renamed");
+
+  nbt::List list = compound["listTest (long)"].getList().share();
+  list.getLongs()[0] = -1;
+  EXPECT_EQ(compound["listTest (long)"].getList().getLongs()[0], 11);
+
+  // Snapshots may be read on another thread while the original is modified
+  nbt::Value live = createTestCompound();
+  nbt::Value save = live.share();
+  std::thread writer([&] {
+    for (int32_t i = 0; i < 1000; i++) live.getCompound()["nested compound test"].getCompound()["ham"].getCompound()["value"] = static_cast<float>(i);
+  });
+  for (int32_t i = 0; i < 1000; i++) EXPECT_EQ(std::as_const(save).getCompound().get("nested compound test")->getCompound().get("ham")->getCompound().get("value")->getFloat(), 0.75F);
+  writer.join();
+  EXPECT_TRUE(save == createTestCompound());
+
+  // Values sharing a payload are equal without comparing it, NaN included
+  nbt::Value nan = nbt::Compound();
+  nan.getCompound()["value"] = std::numeric_limits<float>::quiet_NaN();
+  EXPECT_TRUE(nan.share() == nan);
+  EXPECT_FALSE(nbt::Value(nan) == nan);
+
+  // A reference taken before sharing writes into the shared payload, and stays with the snapshot once the original
+  // is cloned
+  nbt::Value held = createTestCompound();
+  nbt::Compound& stale = held.getCompound();
+  nbt::Value frozen = held.share();
+  stale["intTest"] = 0;
+  EXPECT_EQ(std::as_const(frozen).getCompound().get("intTest")->getInt(), 0);
+  EXPECT_NE(&held.getCompound(), &stale);
+  EXPECT_EQ(&std::as_const(frozen).getCompound(), &stale);
+}
@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+
+#include "test.hpp"
+
+TEST(Nbt, Diff) { //NOLINT
+  const nbt::Compound original = createTestCompound();
+  EXPECT_TRUE(nbt::diff(original, createTestCompound()).empty());
+
+  nbt::Compound modified = original.share();
+  modified["nested compound test"].getCompound()["egg"].getCompound()["value"] = 1.0F;
+  modified["listTest (compound)"].getList()[1].getCompound().remove("created-on");
+  modified["listTest (long)"].getList().getLongs().push_back(16);
+  modified["byteArrayTest (the first 1000 values of (n*n*255+n*7)%100, starting with n=0 (0, 62, 34, 16, 8, ...))"].getByteArray()[500] = -1;
+  modified.remove("shortTest");
+  modified["added"] = "value";
+
+  // Unchanged subtrees are left out, and arrays are patched by the elements that changed
+  nbt::Patch patch = nbt::diff(original, modified);
+  EXPECT_EQ(patch.getEdits().size(), 6);
+  std::vector<char> encoded = patch.encode();
+  EXPECT_LT(encoded.size() * 4, nbt::Writer::writeToBuffer(modified).size());
+
+  nbt::Compound patched = original.share();
+  nbt::apply(patched, nbt::Patch::decode(encoded.data(), encoded.size()));
+  EXPECT_TRUE(patched == modified);
+  EXPECT_TRUE(original == createTestCompound());
+
+  nbt::Compound reverted = modified.share();
+  nbt::apply(reverted, nbt::diff(modified, original));
+  EXPECT_TRUE(reverted == original);
+
+  // Tags changing type are replaced, lists of compounds are patched per element
+  nbt::Compound other = original.share();
+  other["intTest"] = "no longer an int";
+  other["listTest (compound)"].getList().pushBack(nbt::Compound());
+  other["listTest (long)"].getList().getLongs().assign({1, 2, 3});
+  patched = original.share();
+  nbt::apply(patched, nbt::diff(original, other));
+  EXPECT_TRUE(patched == other);
+
+  EXPECT_THROW(nbt::apply(patched, nbt::diff(modified, original)), std::runtime_error);
+  EXPECT_THROW(nbt::Patch::decode(encoded.data(), encoded.size() - 1), std::runtime_error);
+}
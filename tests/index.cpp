@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+
+#include "test.hpp"
+
+TEST(Nbt, OffsetIndex) { //NOLINT
+  std::vector<char> binary = readTestCompound();
+  nbt::OffsetIndex index(binary.data(), binary.size());
+  const nbt::Compound expected = createTestCompound();
+
+  nbt::OffsetIndex::Node level = index.getRoot()["Level"];
+  ASSERT_TRUE(level);
+  EXPECT_EQ(level.getType(), nbt::Type::COMPOUND);
+  EXPECT_EQ(level.size(), expected.size());
+  EXPECT_EQ(level["intTest"].getView().getInt(), 2147483647);
+  EXPECT_FALSE(level["missing"]);
+  EXPECT_FALSE(level["intTest"]["missing"]);
+
+  EXPECT_EQ(index.find("Level.nested compound test.egg.value").getView().getFloat(), 0.5F);
+  EXPECT_EQ(index.find("Level.listTest (long)[3]").getView().getLong(), 14);
+  EXPECT_EQ(index.find("Level.listTest (compound)[1].created-on").getView().getLong(), 1264099775885LL);
+  EXPECT_EQ(index.find("Level.listTest (compound)[1]").getName(), "");
+  EXPECT_EQ(index.find("Level.listTest (long)").size(), 5);
+  EXPECT_FALSE(index.find("Level.listTest (long)[5]"));
+  EXPECT_FALSE(index.find("Level.intTest.value"));
+  EXPECT_THROW(static_cast<void>(index.find("Level.listTest (long)[x]")), std::runtime_error);
+  EXPECT_THROW(static_cast<void>(index.find("Level.listTest (long)[*]")), std::runtime_error);
+  EXPECT_THROW(static_cast<void>(index.find("Level.listTest (long)[99999999999999999999]")), std::runtime_error);
+
+  // Every compound entry resolves to the same payload a view lookup finds.
+  nbt::CompoundView view = nbt::Reader::view(binary.data(), binary.size()).get("Level").getCompound();
+  for (const auto& entry : view) {
+    nbt::View indexed = level[entry.name].getView();
+    EXPECT_EQ(indexed.getType(), entry.value.getType());
+    EXPECT_EQ(indexed.data(), entry.value.data());
+    EXPECT_EQ(indexed.size(), entry.value.size());
+  }
+}
@@ -0,0 +1,69 @@
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "test.hpp"
+
+TEST(Nbt, ListTypedStorage) { //NOLINT
+  std::vector<char> binary = readTestCompound();
+  nbt::Compound document = nbt::Reader::parse(binary.data(), binary.size());
+  const nbt::List& parsed = document["Level"].getCompound()["listTest (long)"].getList();
+
+  ASSERT_TRUE(parsed.hasTypedStorage());
+  EXPECT_EQ(parsed.getLongs(), nbt::LongArray({11, 12, 13, 14, 15}));
+
+  // Const element access boxes into a cache and leaves the typed storage in place.
+  int64_t expected = 11;
+  for (const auto& element : parsed) {
+    EXPECT_EQ(element.getLong(), expected++);
+  }
+  EXPECT_EQ(parsed[4].getLong(), 15);
+  EXPECT_TRUE(parsed.hasTypedStorage());
+  EXPECT_THROW((void) parsed.getInts(), std::runtime_error);
+
+  // Mutable element access converts to Value storage, typed access converts back.
+  nbt::List list = parsed;
+  list[0] = static_cast<int64_t>(-1);
+  EXPECT_FALSE(list.hasTypedStorage());
+  EXPECT_FALSE(list == parsed);
+  list[0] = static_cast<int64_t>(11);
+  EXPECT_TRUE(list == parsed);
+  EXPECT_EQ(list.getLongs().size(), 5);
+  EXPECT_TRUE(list.hasTypedStorage());
+
+  EXPECT_THROW(list.pushBack(static_cast<int32_t>(1)), std::runtime_error);
+}
+
+TEST(Nbt, ListTypedRoundTrip) { //NOLINT
+  nbt::Compound compound;
+  nbt::List bytes(nbt::Type::BYTE), shorts(nbt::Type::SHORT), ints(nbt::Type::INT);
+  nbt::List longs(nbt::Type::LONG), floats(nbt::Type::FLOAT), doubles(nbt::Type::DOUBLE);
+  for (int32_t i = 0; i < 1000; i++) {
+    bytes.getBytes().push_back(static_cast<int8_t>(i));
+    shorts.pushBack(static_cast<int16_t>(i * 31));
+    ints.getInts().push_back(i * 65537);
+    longs.getLongs().push_back(static_cast<int64_t>(i) << 40);
+    floats.pushBack(static_cast<float>(i) / 3);
+    doubles.getDoubles().push_back(static_cast<double>(i) / 7);
+  }
+  compound["bytes"] = bytes;
+  compound["shorts"] = shorts;
+  compound["ints"] = ints;
+  compound["longs"] = longs;
+  compound["floats"] = floats;
+  compound["doubles"] = doubles;
+
+  auto buffer = nbt::Writer::writeToBuffer(compound);
+  nbt::Compound parsed = nbt::Reader::parse(buffer.data(), buffer.size());
+  EXPECT_TRUE(parsed[""].getCompound() == compound);
+
+  std::istringstream stream(std::string(buffer.data(), buffer.size()));
+  EXPECT_TRUE(nbt::Reader::read(stream)[""].getCompound() == compound);
+
+  // Boxed lists encode identically.
+  for (auto& pair : compound) {
+    (void) pair.second.getList().begin();
+    EXPECT_FALSE(pair.second.getList().hasTypedStorage());
+  }
+  EXPECT_EQ(nbt::Writer::writeToBuffer(compound), buffer);
+}
@@ -1,4 +1,6 @@
 #include <fstream>
+#include <memory_resource>
+#include <sstream>
 
 #include <gtest/gtest.h>
 
@@ -9,4 +11,236 @@ TEST(Nbt, Reader) { //NOLINT
   nbt::Compound value = nbt::Reader::parse(binary.data(), binary.size());
 
   EXPECT_TRUE(value["Level"].getCompound() == createTestCompound());
-}
\ No newline at end of file
+}
+
+TEST(Nbt, StreamReader) { //NOLINT
+  std::vector<char> binary = readTestCompound();
+  std::istringstream stream(std::string(binary.data(), binary.size()));
+  nbt::Compound value = nbt::Reader::read(stream);
+
+  EXPECT_TRUE(value == nbt::Reader::parse(binary.data(), binary.size()));
+  EXPECT_THROW(nbt::Reader::parse(binary.data(), binary.size() / 2), std::runtime_error);
+}
+
+TEST(Nbt, ReaderFile) { //NOLINT
+  std::vector<char> binary = readTestCompound();
+  EXPECT_TRUE(nbt::Reader::parseFile("read_test.nbt") == nbt::Reader::parse(binary.data(), binary.size()));
+
+  nbt::FileView file = nbt::Reader::viewFile("read_test.nbt");
+  EXPECT_EQ(file.size(), binary.size());
+  EXPECT_EQ(file.getRoot().get("Level").getCompound().get("intTest").getInt(), 2147483647);
+
+  nbt::FileView moved = std::move(file);
+  EXPECT_EQ(moved.getRoot().get("Level").getCompound().get("stringTest").getString(), createTestCompound()["stringTest"].getString());
+
+  EXPECT_THROW(nbt::Reader::parseFile("missing.nbt"), std::runtime_error);
+}
+
+TEST(Nbt, ReaderMemoryResource) { //NOLINT
+  std::vector<char> binary = readTestCompound();
+  std::vector<char> arena(64 * 1024);
+  std::pmr::monotonic_buffer_resource resource(arena.data(), arena.size(), std::pmr::null_memory_resource());
+
+  // Any allocation escaping the arena would hit the null resource and throw.
+  std::pmr::memory_resource* previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+  nbt::Compound value = nbt::Reader::parse(binary.data(), binary.size(), &resource);
+  std::pmr::set_default_resource(previous);
+
+  EXPECT_EQ(value.getResource(), &resource);
+  EXPECT_EQ(value["Level"].getCompound().getResource(), &resource);
+  EXPECT_TRUE(value["Level"].getCompound() == createTestCompound());
+}
+
+TEST(Nbt, ReaderPaths) { //NOLINT
+  std::vector<char> binary = readTestCompound();
+  nbt::PathSet paths = {"Level.intTest", "Level.listTest (compound)[*].name", "Level.listTest (compound)[1].created-on", "Level.nested compound test.egg", "Level.listTest (long)[3]"};
+  nbt::ReaderOptions options;
+  options.paths = &paths;
+
+  nbt::Compound value = nbt::Reader::parse(binary.data(), binary.size(), options);
+  const nbt::Compound& level = value["Level"].getCompound();
+  const nbt::Compound expected = createTestCompound();
+
+  EXPECT_EQ(level.size(), 4);
+  EXPECT_EQ(level.get("intTest")->getInt(), 2147483647);
+  EXPECT_TRUE(*level.get("nested compound test")->getCompound().get("egg") == *expected.get("nested compound test")->getCompound().get("egg"));
+  EXPECT_FALSE(level.get("nested compound test")->getCompound().hasKey("ham"));
+  EXPECT_EQ(level.get("listTest (long)")->getList().getLongs(), nbt::LongArray({14}));
+
+  const nbt::List& compounds = level.get("listTest (compound)")->getList();
+  ASSERT_EQ(compounds.size(), 2);
+  EXPECT_EQ(compounds[0].getCompound().size(), 1);
+  EXPECT_EQ(compounds[0].getCompound().get("name")->getString(), "Compound tag #0");
+  EXPECT_EQ(compounds[1].getCompound().size(), 2);
+  EXPECT_EQ(compounds[1].getCompound().get("created-on")->getLong(), 1264099775885LL);
+
+  std::istringstream stream(std::string(binary.data(), binary.size()));
+  EXPECT_TRUE(nbt::Reader::read(stream, options) == value);
+
+  EXPECT_THROW(nbt::PathSet({"Level.list[x]"}), std::runtime_error);
+  EXPECT_THROW(nbt::PathSet({"Level.list[0"}), std::runtime_error);
+  EXPECT_EQ(nbt::PathSet::parse("Level.Sections[*][2].Y").size(), 5);
+}
+
+TEST(Nbt, ReaderParallel) { //NOLINT
+  nbt::Compound level = createTestCompound();
+  nbt::List entities(nbt::Type::COMPOUND);
+  for (int32_t i = 0; i < 300; i++) {
+    nbt::Compound entity = createTestCompound();
+    entity["id"] = i;
+    entities.pushBack(std::move(entity));
+  }
+  level["entities"] = std::move(entities);
+  auto binary = nbt::Writer::writeToBuffer(level, "Level");
+
+  nbt::ThreadPool pool(3);
+  nbt::ReaderOptions options;
+  options.pool = &pool;
+  options.parallelThreshold = 4096;
+  options.keyTable = &nbt::KeyTable::global();
+
+  nbt::Compound parallel = nbt::Reader::parse(binary.data(), binary.size(), options);
+  EXPECT_TRUE(parallel == nbt::Reader::parse(binary.data(), binary.size()));
+  EXPECT_EQ(parallel["Level"].getCompound()["entities"].getList()[299].getCompound()["id"].getInt(), 299);
+
+  // Every container with more than one child is split, including a list and its first compound that start together
+  options.parallelThreshold = 0;
+  EXPECT_TRUE(nbt::Reader::parse(binary.data(), binary.size(), options) == parallel);
+
+  // Malformed documents fail the same way as on the serial path.
+  binary.resize(binary.size() - 100);
+  EXPECT_THROW(nbt::Reader::parse(binary.data(), binary.size(), options), std::runtime_error);
+
+  const char huge[] = {0x09, 0x00, 0x00, 0x0A, 0x7F, -1, -1, -1};  // List of 2^31 - 1 compounds
+  EXPECT_THROW(nbt::Reader::parse(huge, sizeof(huge), options), std::runtime_error);
+}
+
+TEST(Nbt, ReaderBatch) { //NOLINT
+  std::vector<std::vector<char>> buffers;
+  for (int32_t i = 0; i < 200; i++) {
+    nbt::Compound item;
+    item["id"] = "minecraft:item_" + std::to_string(i);
+    item["Count"] = static_cast<int8_t>(i % 64);
+    item["Damage"] = static_cast<int16_t>(i);
+    buffers.push_back(nbt::Writer::writeToBuffer(item));
+  }
+  std::vector<std::string_view> documents;
+  for (auto& buffer : buffers) documents.emplace_back(buffer.data(), buffer.size());
+
+  nbt::ThreadPool pool(2);
+  nbt::BatchReader reader(pool);
+  for (int round = 0; round < 2; round++) {  // The second batch reuses the arenas of the first
+    const std::vector<nbt::Compound>& parsed = reader.parse(documents);
+    ASSERT_EQ(parsed.size(), documents.size());
+    for (size_t i = 0; i < parsed.size(); i++) {
+      EXPECT_TRUE(parsed[i] == nbt::Reader::parse(buffers[i].data(), buffers[i].size()));
+    }
+
+    const nbt::BatchStats& stats = reader.getStats();
+    EXPECT_EQ(stats.documents, documents.size());
+    EXPECT_GT(stats.arenas, 0);
+    EXPECT_GT(stats.getBytesPerSecond(), 0);
+  }
+
+  // A pool in the options is ignored: every document is parsed on a single thread, from its slot's arena
+  std::vector<std::vector<char>> large;
+  for (int32_t i = 0; i < 4; i++) {
+    nbt::List entities(nbt::Type::COMPOUND);
+    for (int32_t j = 0; j < 20000; j++) {
+      nbt::Compound entity;
+      entity["id"] = "minecraft:entity_" + std::to_string(j);
+      entity["Pos"] = std::vector<int32_t>{i, j, i + j};
+      entities.pushBack(std::move(entity));
+    }
+    nbt::Compound document;
+    document["Entities"] = std::move(entities);
+    large.push_back(nbt::Writer::writeToBuffer(document));
+  }
+  std::vector<std::string_view> largeDocuments;
+  for (auto& buffer : large) largeDocuments.emplace_back(buffer.data(), buffer.size());
+
+  nbt::ThreadPool inner(2);
+  nbt::ReaderOptions options;
+  options.pool = &inner;
+  options.parallelThreshold = 256;
+  const std::vector<nbt::Compound>& pooled = reader.parse(largeDocuments, options);
+  ASSERT_EQ(pooled.size(), largeDocuments.size());
+  for (size_t i = 0; i < pooled.size(); i++) {
+    EXPECT_TRUE(pooled[i] == nbt::Reader::parse(large[i].data(), large[i].size()));
+  }
+
+  documents.emplace_back("\x0a\x00", 2);
+  EXPECT_THROW(reader.parse(documents), std::runtime_error);
+}
+
+TEST(Nbt, ReaderPushParser) { //NOLINT
+  std::vector<char> binary = readTestCompound();
+  nbt::Compound expected = nbt::Reader::parse(binary.data(), binary.size());
+
+  nbt::PushParser parser;
+  for (size_t fragment : {binary.size(), size_t(1), size_t(3), size_t(7), size_t(1000)}) {
+    size_t offset = 0;
+    nbt::PushParser::Status status = nbt::PushParser::Status::NEED_MORE_DATA;
+    while (status == nbt::PushParser::Status::NEED_MORE_DATA && offset < binary.size()) {
+      size_t length = std::min(fragment, binary.size() - offset);
+      status = parser.feed(binary.data() + offset, length);
+      EXPECT_EQ(parser.getConsumed(), length);
+      offset += length;
+    }
+    ASSERT_EQ(status, nbt::PushParser::Status::DONE);
+    EXPECT_TRUE(parser.takeDocument() == expected);
+  }
+
+  std::vector<char> twice = binary;  // Bytes after the document belong to the next one
+  twice.insert(twice.end(), binary.begin(), binary.end());
+  EXPECT_EQ(parser.feed(twice.data(), twice.size()), nbt::PushParser::Status::DONE);
+  EXPECT_EQ(parser.getConsumed(), binary.size());
+  EXPECT_EQ(parser.getStatus(), nbt::PushParser::Status::DONE);
+  EXPECT_TRUE(parser.takeDocument() == expected);
+
+  EXPECT_EQ(parser.feed(binary.data(), binary.size() / 2), nbt::PushParser::Status::NEED_MORE_DATA);
+  EXPECT_THROW(static_cast<void>(parser.takeDocument()), std::runtime_error);
+  parser.reset();
+
+  EXPECT_EQ(parser.feed("\x0d\x00\x00", 3), nbt::PushParser::Status::INVALID);
+  EXPECT_FALSE(parser.getError().empty());
+  EXPECT_EQ(parser.feed(binary.data(), binary.size()), nbt::PushParser::Status::INVALID);
+}
+
+TEST(Nbt, ReaderLimits) { //NOLINT
+  std::vector<char> binary = readTestCompound();
+  nbt::ReaderOptions options;
+  options.limits = nbt::ReaderLimits::untrusted();
+  EXPECT_TRUE(nbt::Reader::parse(binary.data(), binary.size(), options) == nbt::Reader::parse(binary.data(), binary.size()));
+
+  // A LONG_ARRAY announcing 2^31 - 1 elements, which streams only allocate for as they arrive
+  std::string huge("\x0a\x00\x00\x0c\x00\x01\x61\x7f\xff\xff\xff\x00", 12);
+  EXPECT_THROW(nbt::Reader::parse(huge.data(), huge.size(), options), std::runtime_error);
+  std::istringstream stream(huge);
+  EXPECT_THROW(nbt::Reader::read(stream), std::runtime_error);
+
+  std::string deep("\x0a\x00\x00\x09\x00\x01\x61", 7);  // 1000 lists of lists inside the root compound
+  for (int i = 0; i < 1000; i++) deep.append("\x09\x00\x00\x00\x01", 5);
+  deep.append("\x00\x00\x00\x00\x00\x00", 6);
+  EXPECT_NO_THROW(nbt::Reader::parse(deep.data(), deep.size()));
+  EXPECT_THROW(nbt::Reader::parse(deep.data(), deep.size(), options), std::runtime_error);
+
+  nbt::PathSet paths = {"missing"};  // Skipped tags are held to the depth limit too
+  options.paths = &paths;
+  EXPECT_THROW(nbt::Reader::parse(deep.data(), deep.size(), options), std::runtime_error);
+  options.paths = nullptr;
+
+  nbt::PushParser parser(options);
+  EXPECT_EQ(parser.feed(deep.data(), deep.size()), nbt::PushParser::Status::INVALID);
+  parser.reset();
+  EXPECT_EQ(parser.feed(huge.data(), huge.size()), nbt::PushParser::Status::INVALID);
+
+  options.limits = {};
+  options.limits.maxBytes = 256;
+  EXPECT_THROW(nbt::Reader::parse(binary.data(), binary.size(), options), std::runtime_error);
+  EXPECT_EQ(nbt::PushParser(options).feed(binary.data(), binary.size()), nbt::PushParser::Status::INVALID);
+
+  options.limits = {};
+  options.limits.maxTags = 8;
+  EXPECT_THROW(nbt::Reader::parse(binary.data(), binary.size(), options), std::runtime_error);
+}
@@ -0,0 +1,140 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "test.hpp"
+
+/**
+ * Path of a file in the temporary directory, unique to the test run, which is removed however the test ends.
+ */
+class TemporaryFile {
+ public:
+  explicit TemporaryFile(const std::string& name) {
+    m_Path = (std::filesystem::temp_directory_path() / (name + "_" + std::to_string(std::random_device()()) + ".mca")).string();
+  }
+
+  ~TemporaryFile() {
+    std::remove(m_Path.c_str());
+  }
+
+  TemporaryFile(const TemporaryFile&) = delete;
+  TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+  [[nodiscard]] const std::string& getPath() const { return m_Path; }
+ private:
+  std::string m_Path;
+};
+
+/**
+ * Appends a chunk in sector aligned region layout and records it in the header.
+ */
+void appendChunk(std::string& region, int32_t x, int32_t z, uint8_t compressionId, const std::string& data) {
+  size_t sector = region.size() / nbt::RegionFile::SECTOR_SIZE;
+  auto length = static_cast<uint32_t>(data.size() + 1);
+  region += {static_cast<char>(length >> 24), static_cast<char>(length >> 16), static_cast<char>(length >> 8), static_cast<char>(length), static_cast<char>(compressionId)};
+  region += data;
+
+  size_t sectors = (region.size() - sector * nbt::RegionFile::SECTOR_SIZE + nbt::RegionFile::SECTOR_SIZE - 1) / nbt::RegionFile::SECTOR_SIZE;
+  region.resize((sector + sectors) * nbt::RegionFile::SECTOR_SIZE);
+
+  size_t index = static_cast<size_t>(x + z * 32) * 4;
+  region[index] = static_cast<char>(sector >> 16);
+  region[index + 1] = static_cast<char>(sector >> 8);
+  region[index + 2] = static_cast<char>(sector);
+  region[index + 3] = static_cast<char>(sectors);
+  region[nbt::RegionFile::SECTOR_SIZE + index + 3] = static_cast<char>(x + 1);  // Timestamp
+}
+
+TEST(Nbt, RegionFile) { //NOLINT
+  std::vector<std::pair<int32_t, int32_t>> coordinates = {{0, 0}, {5, 3}, {31, 31}};
+  std::string region(2 * nbt::RegionFile::SECTOR_SIZE, '\0');
+  std::vector<nbt::Compound> chunks;
+
+  for (auto [x, z] : coordinates) {
+    nbt::Compound chunk = createTestCompound();
+    chunk["xPos"] = x;
+    chunk["zPos"] = z;
+
+    std::ostringstream out;
+#ifdef NBT_ZLIB
+    nbt::Writer::write(out, chunk, nbt::Compression::ZLIB);
+    appendChunk(region, x, z, 2, out.str());
+#else
+    nbt::Writer::write(out, chunk);
+    appendChunk(region, x, z, 3, out.str());
+#endif
+    chunks.push_back(std::move(chunk));
+  }
+
+  TemporaryFile temporary("nbt_region_test");
+  const std::string& path = temporary.getPath();
+  std::ofstream(path, std::ios_base::binary).write(region.data(), static_cast<std::streamsize>(region.size()));
+
+  {
+    nbt::RegionFile file(path);
+    EXPECT_EQ(file.getChunks(), coordinates);
+    EXPECT_TRUE(file.hasChunk(-27, 3));  // World coordinates wrap into the region
+    EXPECT_FALSE(file.hasChunk(1, 0));
+    EXPECT_EQ(file.getChunkInfo(31, 31).timestamp, 32);
+
+    EXPECT_TRUE(file.readChunk(5, 3)[""].getCompound() == chunks[1]);
+    EXPECT_EQ(file.readChunk(1, 0).size(), 0);
+
+    nbt::ThreadPool pool(2);
+    std::vector<nbt::Compound> parsed = file.readChunks(coordinates, {}, pool);
+    ASSERT_EQ(parsed.size(), chunks.size());
+    for (size_t i = 0; i < chunks.size(); i++) EXPECT_TRUE(parsed[i][""].getCompound() == chunks[i]);
+
+    std::vector<char> document = file.inflateChunk(31, 31);
+    EXPECT_EQ(nbt::Reader::view(document.data(), document.size()).get("").getCompound().get("xPos").getInt(), 31);
+  }
+
+  EXPECT_THROW(nbt::RegionFile("missing.mca"), std::runtime_error); //NOLINT
+}
+
+TEST(Nbt, RegionWriter) { //NOLINT
+#ifdef NBT_ZLIB
+  nbt::Compression compression = nbt::Compression::ZLIB;
+#else
+  nbt::Compression compression = nbt::Compression::NONE;
+#endif
+  TemporaryFile temporary("nbt_region_writer_test");
+  const std::string& path = temporary.getPath();
+
+  std::vector<nbt::Compound> chunks;
+  for (int32_t i = 0; i < 8; i++) {
+    nbt::Compound chunk = createTestCompound();
+    chunk["xPos"] = i;
+    chunk["noise"] = std::vector<int32_t>(1000 * (i + 1), i);
+    chunks.push_back(std::move(chunk));
+  }
+
+  nbt::ThreadPool pool(2);
+  nbt::RegionWriter writer(path, compression);
+  std::vector<nbt::RegionWriter::Chunk> batch;
+  for (int32_t i = 0; i < 8; i++) batch.push_back({i, 1, &chunks[i]});
+  writer.write(batch, pool);
+
+  // Replacing a chunk appends it while its old sectors stay reserved, the next replacement reuses them.
+  writer.write({{2, 1, &chunks[2]}, {3, 1, nullptr}}, pool);
+  auto size = std::filesystem::file_size(path);
+  writer.write({{2, 1, &chunks[2]}}, pool);
+  EXPECT_EQ(std::filesystem::file_size(path), size);
+  EXPECT_EQ(size % nbt::RegionFile::SECTOR_SIZE, 0);
+
+  {
+    nbt::RegionFile file(path);
+    EXPECT_EQ(file.getChunks().size(), 7);
+    EXPECT_FALSE(file.hasChunk(3, 1));
+    EXPECT_NE(file.getChunkInfo(2, 1).timestamp, 0);
+    for (int32_t i = 0; i < 8; i++) {
+      if (i != 3) {
+        EXPECT_TRUE(file.readChunk(i, 1)[""].getCompound() == chunks[i]);
+      }
+    }
+  }
+}
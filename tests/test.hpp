@@ -1,19 +1,13 @@
 #ifndef NBT_TESTS_TEST_HPP_
 #define NBT_TESTS_TEST_HPP_
 
-#include <fstream>
-
 #include <gtest/gtest.h>
 
 #include "nbt/nbt.hpp"
 
 inline std::vector<char> readTestCompound() {
-  std::ifstream in("read_test.nbt", std::ios_base::binary | std::ios_base::ate);
-  if (!in.is_open()) throw std::runtime_error("failed to open read_test.nbt");
-  std::vector<char> buffer(in.tellg());
-  in.seekg(0);
-  in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
-  return std::move(buffer);
+  nbt::FileView file = nbt::Reader::viewFile("read_test.nbt");
+  return {file.data(), file.data() + file.size()};
 }
 
 inline nbt::Compound createTestCompound() {
@@ -34,7 +28,7 @@ inline nbt::Compound createTestCompound() {
 
   level["intTest"] = static_cast<int32_t>(2147483647);
   level["byteTest"] = static_cast<int8_t>(127);
-  level["stringTest"] = "HELLO WORLD THIS IS A TEST STRING \xc5\xc4\xd6!";
+  level["stringTest"] = "HELLO WORLD THIS IS A TEST STRING \xc3\x85\xc3\x84\xc3\x96!";
 
   {
     nbt::List listLong(nbt::Type::LONG);
@@ -48,7 +42,7 @@ inline nbt::Compound createTestCompound() {
 
   level["doubleTest"] = 0.49312871321823148;
   level["floatTest"] = 0.49823147058486938F;
-  level["longTest"] = 9223372036854775807LL;
+  level["longTest"] = static_cast<int64_t>(9223372036854775807LL);
 
   {
     nbt::List listCompound(nbt::Type::COMPOUND);
@@ -56,7 +50,7 @@ inline nbt::Compound createTestCompound() {
     size_t index = 0;
     for (size_t i = 0; i < 2; i++) {
       nbt::Compound elementCompound;
-      elementCompound["created-on"] = 1264099775885LL;
+      elementCompound["created-on"] = static_cast<int64_t>(1264099775885LL);
       elementCompound["name"] = "Compound tag #" + std::to_string(index++);
       listCompound.emplaceBack(std::move(elementCompound));
     }
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include "test.hpp"
+
+TEST(Nbt, View) { //NOLINT
+  std::vector<char> binary = readTestCompound();
+  nbt::CompoundView document = nbt::Reader::view(binary.data(), binary.size());
+  nbt::CompoundView level = document.get("Level").getCompound();
+  nbt::Compound expected = createTestCompound();
+
+  EXPECT_EQ(level.size(), expected.size());
+  EXPECT_EQ(level.get("intTest").getInt(), expected["intTest"].getInt());
+  EXPECT_EQ(level.get("longTest").getLong(), expected["longTest"].getLong());
+  EXPECT_EQ(level.get("doubleTest").getDouble(), expected["doubleTest"].getDouble());
+  EXPECT_EQ(level.get("stringTest").getString(), expected["stringTest"].getString());
+  EXPECT_FALSE(level.get("stringTest").isAscii());
+  EXPECT_FALSE(level.get("missing"));
+
+  nbt::CompoundView egg = level.get("nested compound test").getCompound().get("egg").getCompound();
+  EXPECT_EQ(egg.get("name").getStringView(), "Eggbert");
+  EXPECT_EQ(egg.get("value").getFloat(), 0.5f);
+
+  nbt::ListView longs = level.get("listTest (long)").getList();
+  ASSERT_EQ(longs.size(), 5);
+  EXPECT_EQ(longs[4].getLong(), 15);
+
+  nbt::ListView compounds = level.get("listTest (compound)").getList();
+  size_t count = 0;
+  for (const nbt::View& element : compounds) {
+    EXPECT_EQ(element.getCompound().get("created-on").getLong(), 1264099775885LL);
+    count++;
+  }
+  EXPECT_EQ(count, 2);
+
+  for (const auto& entry : level) {
+    if (entry.value.getType() != nbt::Type::BYTE_ARRAY) continue;
+    EXPECT_EQ(entry.value.getByteArray().toVector(), expected[std::string(entry.name).c_str()].getByteArray());
+  }
+}
+
+TEST(Nbt, ViewArrays) { //NOLINT
+  nbt::Compound compound;
+  compound["\xc3\xa5 \xed\xa0\xbd\xed\xb8\x80"] = static_cast<int8_t>(1);  // Modified UTF-8, as Java writes names
+  compound["c\xc0\x80" "d"] = static_cast<int8_t>(2);
+  compound[std::string_view("a\0b", 3)] = static_cast<int8_t>(3);
+  compound["ints"] = std::vector<int32_t>{1, -2, 0x12345678};
+  compound["longs"] = std::vector<int64_t>{-1, 0x0102030405060708LL};
+  auto buffer = nbt::Writer::writeToBuffer(compound);
+
+  nbt::CompoundView root = nbt::Reader::view(buffer.data(), buffer.size()).get("").getCompound();
+  EXPECT_EQ(root.get("ints").getIntArray().toVector(), compound["ints"].getIntArray());
+  EXPECT_EQ(root.get("longs").getLongArray()[1], 0x0102030405060708LL);
+
+  // Keys that are not plain ASCII match names stored as is or as modified UTF-8
+  EXPECT_EQ(root.get("\xc3\xa5 \xf0\x9f\x98\x80").getByte(), 1);
+  EXPECT_EQ(root.get(std::string_view("c\0d", 3)).getByte(), 2);
+  EXPECT_EQ(root.get(std::string_view("a\0b", 3)).getByte(), 3);
+  EXPECT_FALSE(root.hasKey("\xc3\xa5"));
+
+  EXPECT_THROW((void) nbt::Reader::view(buffer.data(), buffer.size() - 4).get("").getCompound().get("longs"), std::runtime_error);
+}
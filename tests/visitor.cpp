@@ -0,0 +1,67 @@
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "test.hpp"
+
+/**
+ * Flattens the visited events into one line per tag.
+ */
+class TraceVisitor : public nbt::Visitor {
+ public:
+  void onByte(std::string_view name, int8_t value) override { add(name, std::to_string(value)); }
+  void onShort(std::string_view name, int16_t value) override { add(name, std::to_string(value)); }
+  void onInt(std::string_view name, int32_t value) override { add(name, std::to_string(value)); }
+  void onLong(std::string_view name, int64_t value) override { add(name, std::to_string(value)); }
+  void onFloat(std::string_view name, float value) override { add(name, std::to_string(value)); }
+  void onDouble(std::string_view name, double value) override { add(name, std::to_string(value)); }
+  void onByteArray(std::string_view name, nbt::ArrayView<int8_t> values) override { add(name, "bytes " + std::to_string(values.size())); }
+  void onIntArray(std::string_view name, nbt::ArrayView<int32_t> values) override { add(name, "ints " + std::to_string(values.size())); }
+  void onLongArray(std::string_view name, nbt::ArrayView<int64_t> values) override { add(name, "longs " + std::to_string(values.size())); }
+  void onString(std::string_view name, std::string_view value) override { add(name, std::string(value)); }
+
+  bool onListBegin(std::string_view name, nbt::Type elementType, size_t length) override {
+    add(name, "list " + std::to_string(static_cast<int>(elementType)) + " " + std::to_string(length));
+    return true;
+  }
+  void onListEnd() override { add({}, "end"); }
+
+  bool onCompoundBegin(std::string_view name) override {
+    add(name, "compound");
+    return name != "nested compound test";
+  }
+  void onCompoundEnd() override { add({}, "end"); }
+
+  std::string trace;
+ private:
+  void add(std::string_view name, const std::string& event) {
+    trace.append(name).append(": ").append(event).append("\n");
+  }
+};
+
+TEST(Nbt, Visitor) { //NOLINT
+  std::vector<char> binary = readTestCompound();
+  TraceVisitor buffer;
+  nbt::Reader::visit(binary.data(), binary.size(), buffer);
+
+  std::istringstream stream(std::string(binary.data(), binary.size()));
+  TraceVisitor streamed;
+  nbt::Reader::visit(stream, streamed);
+
+  EXPECT_EQ(buffer.trace, streamed.trace);
+  EXPECT_NE(buffer.trace.find("Level: compound\n"), std::string::npos);
+  EXPECT_NE(buffer.trace.find("listTest (long): list 4 5\n: 11\n: 12\n: 13\n: 14\n: 15\n: end\n"), std::string::npos);
+  EXPECT_NE(buffer.trace.find("stringTest: HELLO WORLD THIS IS A TEST STRING \xc3\x85\xc3\x84\xc3\x96!\n"), std::string::npos);
+  EXPECT_NE(buffer.trace.find("byteArrayTest (the first 1000 values of (n*n*255+n*7)%100, starting with n=0 (0, 62, 34, 16, 8, ...)): bytes 1000\n"), std::string::npos);
+
+  // The skipped compound's entries are not reported.
+  EXPECT_NE(buffer.trace.find("nested compound test: compound\n"), std::string::npos);
+  EXPECT_EQ(buffer.trace.find("ham: compound"), std::string::npos);
+
+  EXPECT_THROW(nbt::Reader::visit(binary.data(), binary.size() / 2, buffer), std::runtime_error);
+
+  // A LONG_ARRAY announcing 2^31 - 1 elements fails once the stream runs dry, before 16 GiB are allocated for it
+  std::istringstream huge(std::string("\x0a\x00\x00\x0c\x00\x01\x61\x7f\xff\xff\xff\x00", 12));
+  EXPECT_THROW(nbt::Reader::visit(huge, streamed), std::runtime_error);
+}
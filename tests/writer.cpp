@@ -1,3 +1,5 @@
+#include <sstream>
+
 #include <gtest/gtest.h>
 
 #include "test.hpp"
@@ -7,4 +9,133 @@ TEST(Nbt, Writer) { //NOLINT
   auto buffer = nbt::Writer::writeToBuffer(compound, "Level");
   auto parsed = nbt::Reader::parse(buffer.data(), buffer.size());
   EXPECT_TRUE(parsed["Level"].getCompound() == compound);
-}
\ No newline at end of file
+}
+
+TEST(Nbt, WriterBuffers) { //NOLINT
+  nbt::Compound compound = createTestCompound();
+  auto buffer = nbt::Writer::writeToBuffer(compound, "Level");
+  EXPECT_EQ(buffer.size(), nbt::Writer::getEncodedSize(compound, "Level"));
+  EXPECT_EQ(buffer.size(), readTestCompound().size());
+
+  std::vector<char> reused(1 << 16);
+  const char* data = reused.data();
+  nbt::Writer::writeToBuffer(compound, reused, "Level");
+  EXPECT_EQ(reused, buffer);
+  EXPECT_EQ(reused.data(), data);
+
+  std::vector<char> fixed(buffer.size());
+  EXPECT_EQ(nbt::Writer::writeToBuffer(compound, fixed.data(), fixed.size(), "Level"), buffer.size());
+  EXPECT_EQ(fixed, buffer);
+  EXPECT_THROW(nbt::Writer::writeToBuffer(compound, fixed.data(), fixed.size() - 1, "Level"), std::runtime_error);
+
+  std::ostringstream stream;
+  nbt::Writer::write(stream, compound, "Level");
+  EXPECT_EQ(stream.str(), std::string(buffer.data(), buffer.size()));
+}
+#ifdef NBT_ZLIB
+TEST(Nbt, WriterCompressed) { //NOLINT
+  nbt::Compound compound = createTestCompound();
+  compound["large"] = std::vector<int64_t>(100000, 0x0102030405060708LL);  // Larger than the inflate window
+
+  for (nbt::Compression compression : {nbt::Compression::GZIP, nbt::Compression::ZLIB}) {
+    std::ostringstream out;
+    nbt::Writer::write(out, compound, compression, "Level");
+    std::string compressed = out.str();
+    EXPECT_LT(compressed.size(), nbt::Writer::getEncodedSize(compound, "Level") / 10);
+
+    auto parsed = nbt::Reader::parse(compressed.data(), compressed.size());
+    EXPECT_TRUE(parsed["Level"].getCompound() == compound);
+
+    std::istringstream in(compressed);
+    EXPECT_TRUE(nbt::Reader::read(in) == parsed);
+
+    // Reading a compressed document leaves a seekable stream at the data following it
+    std::istringstream concatenated(compressed + compressed + "tail");
+    EXPECT_TRUE(nbt::Reader::read(concatenated) == parsed);
+    EXPECT_TRUE(nbt::Reader::read(concatenated) == parsed);
+    std::string tail;
+    concatenated >> tail;
+    EXPECT_EQ(tail, "tail");
+
+    EXPECT_THROW(nbt::Reader::parse(compressed.data(), compressed.size() / 2), std::runtime_error);
+  }
+}
+#endif
+TEST(Nbt, WriterStrings) { //NOLINT
+  nbt::Compound compound;
+  compound["nul"] = std::string("a\0b", 3);
+  compound["emoji"] = "long enough for the vector scan \xf0\x9f\x98\x80 and \xc3\xa5\xe2\x82\xac";
+  compound["surrogate"] = "\xed\xa0\x80!";  // Unpaired, survives as is
+
+  auto buffer = nbt::Writer::writeToBuffer(compound);
+  std::string encoded(buffer.data(), buffer.size());
+  EXPECT_NE(encoded.find("a\xc0\x80" "b"), std::string::npos);
+  EXPECT_NE(encoded.find("\xed\xa0\xbd\xed\xb8\x80"), std::string::npos);
+
+  EXPECT_TRUE(nbt::Reader::parse(buffer.data(), buffer.size())[""].getCompound() == compound);
+
+  nbt::CompoundView view = nbt::Reader::view(buffer.data(), buffer.size()).get("").getCompound();
+  EXPECT_FALSE(view.get("emoji").isAscii());
+  EXPECT_EQ(view.get("emoji").getString(), compound["emoji"].getString());
+  EXPECT_EQ(view.get("nul").getString(), compound["nul"].getString());
+}
+
+TEST(Nbt, WriterFormats) { //NOLINT
+  nbt::Compound compound = createTestCompound();
+  compound["edgeLongs"] = std::vector<int64_t>{-1, INT64_MIN, INT64_MAX, 0};
+  compound["edgeInts"] = std::vector<int32_t>{-64, 63, INT32_MIN};
+
+  for (nbt::Format format : {nbt::Format::JAVA, nbt::Format::JAVA_NETWORK, nbt::Format::BEDROCK, nbt::Format::BEDROCK_NETWORK}) {
+    auto buffer = nbt::Writer::writeToBuffer(compound, format, "Level");
+    EXPECT_EQ(buffer.size(), nbt::Writer::getEncodedSize(compound, format, "Level"));
+
+    nbt::ReaderOptions options;
+    options.format = format;
+    auto parsed = nbt::Reader::parse(buffer.data(), buffer.size(), options);
+    EXPECT_TRUE(parsed[format == nbt::Format::JAVA_NETWORK ? "" : "Level"].getCompound() == compound);
+
+    nbt::ThreadPool pool(1);
+    options.pool = &pool;
+    options.parallelThreshold = 64;  // Exercises scanning ahead in the format
+    EXPECT_TRUE(nbt::Reader::parse(buffer.data(), buffer.size(), options) == parsed);
+  }
+  EXPECT_EQ(nbt::Writer::writeToBuffer(compound, nbt::Format::JAVA, "Level"), nbt::Writer::writeToBuffer(compound, "Level"));
+
+  nbt::Compound small;
+  small["a"] = static_cast<int32_t>(-1);
+  small["s"] = "\xc3\xa5";
+  EXPECT_EQ(nbt::Writer::writeToBuffer(small, nbt::Format::JAVA_NETWORK), std::vector<char>({
+      '\x0a', '\x03', '\x00', '\x01', 'a', '\xff', '\xff', '\xff', '\xff',
+      '\x08', '\x00', '\x01', 's', '\x00', '\x02', '\xc3', '\xa5', '\x00'}));
+  EXPECT_EQ(nbt::Writer::writeToBuffer(small, nbt::Format::BEDROCK, "n"), std::vector<char>({
+      '\x0a', '\x01', '\x00', 'n', '\x03', '\x01', '\x00', 'a', '\xff', '\xff', '\xff', '\xff',
+      '\x08', '\x01', '\x00', 's', '\x02', '\x00', '\xc3', '\xa5', '\x00'}));
+  EXPECT_EQ(nbt::Writer::writeToBuffer(small, nbt::Format::BEDROCK_NETWORK), std::vector<char>({
+      '\x0a', '\x00', '\x03', '\x01', 'a', '\x01', '\x08', '\x01', 's', '\x02', '\xc3', '\xa5', '\x00'}));
+}
+
+TEST(Nbt, WriterArrays) { //NOLINT
+  nbt::Compound compound;
+  for (int32_t length : {0, 1, 3, 4, 7, 8, 9, 31, 33, 4097}) {
+    std::vector<int32_t> ints(length);
+    std::vector<int64_t> longs(length);
+    for (int32_t i = 0; i < length; i++) {
+      ints[i] = static_cast<int32_t>(0x01020304U * static_cast<uint32_t>(i + 1));
+      longs[i] = static_cast<int64_t>(0x0102030405060708ULL * static_cast<uint64_t>(i + 1));
+    }
+    compound.insert("ints" + std::to_string(length), std::move(ints));
+    compound.insert("longs" + std::to_string(length), std::move(longs));
+  }
+
+  auto buffer = nbt::Writer::writeToBuffer(compound);
+  EXPECT_TRUE(nbt::Reader::parse(buffer.data(), buffer.size())[""].getCompound() == compound);
+
+  nbt::CompoundView view = nbt::Reader::view(buffer.data(), buffer.size()).get("").getCompound();
+  for (auto& pair : compound) {
+    if (pair.second.getType() == nbt::Type::INT_ARRAY) {
+      EXPECT_EQ(view.get(pair.first).getIntArray().toVector(), pair.second.getIntArray());
+    } else {
+      EXPECT_EQ(view.get(pair.first).getLongArray().toVector(), pair.second.getLongArray());
+    }
+  }
+}